@@ -32,4 +32,9 @@ void minSumFromMinValueOfPairs();
 void minChangesNonIncreasingArray();
 void minChangesGCDMultipleOfK();
 void min_max_lexicographic_number();
+void min_max_product_subset();
+void min_max_product_subset_benchmark();
+void max_sum_k_negations_benchmark();
+void max_sum_elementMultipliedWithIndex_benchmark();
+void maxSum_increasingOrderElementsFromNArrays_benchmark();
 
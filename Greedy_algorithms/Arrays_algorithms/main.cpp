@@ -37,4 +37,14 @@ int main()
 	minChangesGCDMultipleOfK();
 	std::cout<<std::endl<<"--------Min/max lexicograph. numbers from array digits with k swaps. Tip: As k can be > arr.size(), adjust the upper bound for the searching subarray to min(arr.size(), idx+k+1)-------"<<std::endl;
 	min_max_lexicographic_number();
+	std::cout<<std::endl<<"--------Min and max product subsets in one pass. Tip: both need only the zeroes and negatives counts, the extreme values and the product of non zero values. Keep the product in 128 bits, log domain or modulo a prime--------"<<std::endl;
+	min_max_product_subset();
+	std::cout<<std::endl<<"--------Min and max product subsets for 10^8 values, on 1 thread and on all of them. Tip: large inputs take seconds, so this driver is not run by default--------"<<std::endl;
+	//min_max_product_subset_benchmark();
+	std::cout<<std::endl<<"--------Max sum after k negations for 10^8 values. Tip: selection (nth_element) instead of a full sort or heap, and a single pass when k exceeds the negatives count--------"<<std::endl;
+	//max_sum_k_negations_benchmark();
+	std::cout<<std::endl<<"--------Max sum arr[index]*index for 10^8 values. Tip: the sum only needs the sorted order, so use counting sort for a narrow range of values and radix sort otherwise--------"<<std::endl;
+	//max_sum_elementMultipliedWithIndex_benchmark();
+	std::cout<<std::endl<<"--------Max sum of increasing order elements from 10^5 arrays. Tip: sort each array once, in parallel, or only when it is reached, then binary search the largest value below the previous pick--------"<<std::endl;
+	//maxSum_increasingOrderElementsFromNArrays_benchmark();
 }
@@ -1,4 +1,7 @@
 #include "array_greedy_algorithms.hpp"
+#include "../parallel_helpers.hpp"
+#include "../benchmark_helpers.hpp"
+#include <cstdint>
 
 /* Maximum sum of increasing order elements from n arrays
  * 
@@ -10,6 +13,13 @@
  *               - compute maximum for each vector. When finding a max for a given vector, but the 1st, it should be verified if the newly found max value is greater than i-1 th, or smaller than i+1 th
  * 			Also, the Greedy approach is used once again as it is started with the last vector in order to increase chances to accomplish the result. If started from the first, it is possible to select a max value
  * 			which would be greater than the maximum value of the next vectors and the result would be 0. The idea is to ry to cover all vectors.
+ *
+ * 			For many vectors (M = 10^5 of N = 10^3 values), the sorting strategy is improved in 3 ways:
+ * 				 - once a vector is sorted, the pick (the greatest value smaller than the previous pick) is found by binary search: lower_bound(previous) - 1, in O(logN) instead of O(N)
+ * 				 - if a vector has no value smaller than the previous pick, the result is 0 and the remaining vectors are not looked at
+ * 				 - the vectors are either all sorted upfront, in parallel (ranges of vectors per thread), or each one is sorted only when it is reached, so an early stop also skips the sorting
+ * 			Sorting still costs O(M*NlogN), so for vectors used only once, the max strategy (O(M*N), no sorting) remains the cheapest when the selection goes through all vectors. The binary search
+ * 			pays off when the sorted vectors are queried again, or when the selection stops early and the remaining vectors are never sorted.
  */ 
 
 namespace max_sum_increasing_order_elements
@@ -48,7 +58,7 @@ namespace max_sum_increasing_order_elements
 		file.close();
 	}
 
-	void compute_sum_sorting(vector<vector<int>>& input_vectors, vector<pair<int, size_t>>& selected_items, int& sum)
+	void compute_sum_sorting(vector<vector<int>>& input_vectors, vector<pair<int, size_t>>& selected_items, int64_t& sum)
 	{
 		//Step 1: sort all vectors in ascending order: O(M*N*LogN) complexity
 		for(auto& vec : input_vectors)
@@ -91,7 +101,7 @@ namespace max_sum_increasing_order_elements
 		} 
 	}
 	
-	void compute_sum_max(vector<vector<int>>& input_vectors, vector<pair<int, size_t>>& selected_items, int& sum)
+	void compute_sum_max(vector<vector<int>>& input_vectors, vector<pair<int, size_t>>& selected_items, int64_t& sum)
 	{
 		int max = numeric_limits<int>::min();
 		
@@ -138,7 +148,90 @@ namespace max_sum_increasing_order_elements
 		} 
 	}
 	
-	void print_selected_elements(const std::vector<std::pair<int, size_t>>& selected_elements, const int& sum)
+	//the vectors are sorted in place. With presort set, all of them are sorted in parallel before selecting, otherwise each one is sorted when it is reached
+	void compute_sum_binary_search(vector<vector<int>>& input_vectors, vector<pair<int, size_t>>& selected_items, int64_t& sum, bool presort,
+								   unsigned workers = parallel_helpers::workers_count())
+	{
+		if(input_vectors.empty())
+		{
+			return;
+		}
+
+		//Step 1: sort, if requested upfront
+		if(presort)
+		{
+			parallel_helpers::parallel_for_ranges(input_vectors.size(), [&](size_t first, size_t last, unsigned)
+				{
+					for(size_t idx = first; idx < last; ++idx)
+					{
+						sort(input_vectors[idx].begin(), input_vectors[idx].end());
+					}
+				}, workers);
+		}
+
+		//Step 2: start from the last vector. Each pick is the greatest value smaller than the previous one, so the first pick is the maximum of the last vector
+		int64_t previous = numeric_limits<int64_t>::max();
+		for(size_t idx = input_vectors.size(); idx > 0; --idx)
+		{
+			vector<int>& vec = input_vectors[idx-1];
+			if(!presort)
+			{
+				sort(vec.begin(), vec.end());
+			}
+
+			//values < previous are found before lower_bound(previous)
+			auto bound = previous == numeric_limits<int64_t>::max() ? vec.end() : lower_bound(vec.begin(), vec.end(), static_cast<int>(previous));
+			//early stop: no valid pick in this vector
+			if(bound == vec.begin())
+			{
+				return;
+			}
+			previous = *(bound - 1);
+			selected_items.push_back(make_pair(static_cast<int>(previous), idx));
+		}
+
+		//Step 3: all vectors have a pick
+		for(const auto& item : selected_items)
+		{
+			sum += item.first;
+		}
+	}
+
+	//vectors whose values ranges overlap and increase, so a full increasing selection exists, or fully random vectors, for which the selection stops early
+	void benchmark(size_t vectors, size_t size, bool increasing_ranges)
+	{
+		vector<vector<int>> input_vectors(vectors, vector<int>(size));
+		benchmark_helpers::random_generator generator;
+		for(size_t idx = 0; idx < vectors; ++idx)
+		{
+			for(int& value : input_vectors[idx])
+			{
+				value = increasing_ranges ? static_cast<int>(idx*1000 + generator.next(10000)) : static_cast<int>(generator.next()>>1);
+			}
+		}
+
+		using strategy = void (*)(vector<vector<int>>&, vector<pair<int, size_t>>&, int64_t&);
+		const pair<const char*, strategy> strategies[] =
+		{
+			{"sort all, linear scans", [](vector<vector<int>>& vecs, vector<pair<int, size_t>>& items, int64_t& sum){compute_sum_sorting(vecs, items, sum);}},
+			{"max scans", [](vector<vector<int>>& vecs, vector<pair<int, size_t>>& items, int64_t& sum){compute_sum_max(vecs, items, sum);}},
+			{"parallel sort, binary search", [](vector<vector<int>>& vecs, vector<pair<int, size_t>>& items, int64_t& sum){compute_sum_binary_search(vecs, items, sum, true);}},
+			{"sort on demand, binary search", [](vector<vector<int>>& vecs, vector<pair<int, size_t>>& items, int64_t& sum){compute_sum_binary_search(vecs, items, sum, false);}}
+		};
+
+		cout<<"benchmark for "<<vectors<<" vectors of "<<size<<" values, "<<(increasing_ranges ? "increasing ranges" : "random values")<<endl;
+		for(const auto& named_strategy : strategies)
+		{
+			//the strategies sort their input, so each one gets its own copy
+			vector<vector<int>> scratch(input_vectors);
+			vector<pair<int, size_t>> selected_items;
+			int64_t sum = 0;
+			double elapsed = benchmark_helpers::seconds([&]{named_strategy.second(scratch, selected_items, sum);});
+			cout<<"    "<<named_strategy.first<<": "<<selected_items.size()<<" picks, sum "<<sum<<" in "<<elapsed<<" s"<<endl;
+		}
+	}
+
+	void print_selected_elements(const std::vector<std::pair<int, size_t>>& selected_elements, const int64_t& sum)
 	{
 		//cout<<" job id "<<" deadline "<<" profit "<<" day of execution"<<endl;
 		for(auto it=selected_elements.cbegin(), end=selected_elements.cend(); it!=end; ++it)
@@ -154,7 +247,7 @@ void maxSum_increasingOrderElementsFromNArrays()
 {
 	std::vector<std::vector<int>> input_vectors;
 	std::vector<std::pair<int, size_t>> selected_elements;
-	int result{0};
+	int64_t result{0};
 	
 	max_sum_increasing_order_elements::read_input_vectors(input_vectors);
 
@@ -165,4 +258,15 @@ void maxSum_increasingOrderElementsFromNArrays()
 	result = 0;
 	max_sum_increasing_order_elements::compute_sum_max(input_vectors, selected_elements, result);
 	max_sum_increasing_order_elements::print_selected_elements(selected_elements, result);
+
+	selected_elements.clear();
+	result = 0;
+	max_sum_increasing_order_elements::compute_sum_binary_search(input_vectors, selected_elements, result, true);
+	max_sum_increasing_order_elements::print_selected_elements(selected_elements, result);
+}
+
+void maxSum_increasingOrderElementsFromNArrays_benchmark()
+{
+	max_sum_increasing_order_elements::benchmark(100000, 1000, true);
+	max_sum_increasing_order_elements::benchmark(100000, 1000, false);
 }
@@ -1,4 +1,7 @@
 #include "array_greedy_algorithms.hpp"
+#include "../parallel_helpers.hpp"
+#include "../benchmark_helpers.hpp"
+#include <cstdint>
 
 /* Maximize the sum of arr[i]*i
  * 
@@ -6,6 +9,20 @@
  * 
  * Approach: As the array's index is increasing, in order to maximize the result, it should be multiplied with the highest values in array. 
  * 			 Thus, the Greedy approach comes from the need to sort the array in ascending order and compute the sum of products.
+ *
+ * 			 For large arrays of integers from a bounded range, the comparison sort is not needed:
+ * 				- if max - min is small enough, the values are counted (counting sort). The sorted array does not even have to be built: a value v found c times, starting at rank r,
+ * 				  contributes v * (r + (r+1) + ... + (r+c-1)) = v * (c*r + c*(c-1)/2). The counting is done in parallel, with one histogram per thread.
+ * 				- otherwise, the values are sorted by LSD radix sort (4 passes of 8 bits, the sign bit flipped so negatives come first), then the sum of sorted[i]*i is computed in blocks of 4096
+ * 				  elements: sum of v[base+j]*(base+j) = base * (sum of v) + sum of v[base+j]*j, where both inner sums fit in 64 bits (|v| < 2^31, j < 2^12), so the inner loop is a plain
+ * 				  64 bits multiply-add the compiler vectorizes. Blocks are summed in parallel.
+ * 			 The total itself can exceed 64 bits (10^9 values of 2^31 times indexes of 2^30), so it is accumulated in 128 bits and the result stays exact.
+ *
+ * 			 When the values change continuously (a multiset with insertions and deletions), the sum is maintained instead of recomputed (dynamic_rank_sum). When a value v is inserted:
+ * 				- it gets rank r = number of values <= v (it is placed after its equals, which gives the same sum as any other place among them), so it adds v*r
+ * 				- every value > v moves one rank up, so the sum grows by the sum of all values > v, at once
+ * 			 and a deletion does the opposite. Both need the count and the sum of the values <= v, which are prefix queries on 2 Fenwick trees indexed by the rank of v among all the
+ * 			 values that can appear (coordinate compression). So every update is O(logN).
  */ 
 
 namespace maxSumElemIndex
@@ -69,6 +86,308 @@ namespace maxSumElemIndex
 		}
 	}
 	
+	//above this range, a histogram per thread costs more than radix sorting
+	const int64_t max_counting_range = int64_t{1}<<22;
+
+	//sum of sorted[i]*i, in blocks whose inner sums fit in 64 bits
+	__int128 ramp_dot_product(const int* sorted, size_t size, unsigned workers)
+	{
+		const size_t block = 4096;
+		size_t blocks = (size + block - 1)/block;
+		vector<__int128> partial(max(workers, 1u), 0);
+		parallel_helpers::parallel_for_ranges(blocks, [&](size_t first_block, size_t last_block, unsigned worker)
+			{
+				__int128 total = 0;
+				for(size_t block_idx = first_block; block_idx < last_block; ++block_idx)
+				{
+					size_t base = block_idx*block, count = min(block, size - base);
+					const int* values = sorted + base;
+					int64_t sum = 0, ramp_sum = 0;
+					for(size_t idx = 0; idx < count; ++idx)
+					{
+						sum += values[idx];
+						ramp_sum += static_cast<int64_t>(values[idx])*static_cast<int64_t>(idx);
+					}
+					total += static_cast<__int128>(base)*sum + ramp_sum;
+				}
+				partial[worker] = total;
+			}, workers);
+
+		__int128 total = 0;
+		for(__int128 worker_total : partial)
+		{
+			total += worker_total;
+		}
+		return total;
+	}
+
+	//values in [min_value, min_value + range): one histogram per thread, merged, then every distinct value contributes v * (c*r + c*(c-1)/2)
+	__int128 max_sum_counting(const vector<int>& values, int min_value, int64_t range, unsigned workers)
+	{
+		vector<vector<uint64_t>> histograms(max(workers, 1u));
+		parallel_helpers::parallel_for_ranges(values.size(), [&](size_t first, size_t last, unsigned worker)
+			{
+				vector<uint64_t>& histogram = histograms[worker];
+				histogram.assign(range, 0);
+				for(size_t idx = first; idx < last; ++idx)
+				{
+					++histogram[values[idx] - min_value];
+				}
+			}, workers);
+
+		__int128 total = 0;
+		uint64_t rank = 0;
+		for(int64_t offset = 0; offset < range; ++offset)
+		{
+			uint64_t count = 0;
+			for(const vector<uint64_t>& histogram : histograms)
+			{
+				count += histogram.empty() ? 0 : histogram[offset];
+			}
+			if(count != 0)
+			{
+				unsigned __int128 ranks_sum = static_cast<unsigned __int128>(count)*rank + static_cast<unsigned __int128>(count)*(count-1)/2;
+				total += static_cast<__int128>(min_value + offset)*static_cast<__int128>(ranks_sum);
+				rank += count;
+			}
+		}
+		return total;
+	}
+
+	//LSD radix sort on the values with their sign bit flipped, so the unsigned order is the signed one. 8 bits per pass; the 4 histograms are counted in a single read of the keys
+	//and a pass is skipped if all values share its digit
+	void radix_sort(vector<int>& values)
+	{
+		size_t size = values.size();
+		vector<uint32_t> keys(size), buffer(size);
+		vector<array<size_t, 256>> counts(4);
+		for(array<size_t, 256>& digit_counts : counts)
+		{
+			digit_counts.fill(0);
+		}
+		for(size_t idx = 0; idx < size; ++idx)
+		{
+			uint32_t key = static_cast<uint32_t>(values[idx]) ^ 0x80000000u;
+			keys[idx] = key;
+			++counts[0][key & 0xFF];
+			++counts[1][(key>>8) & 0xFF];
+			++counts[2][(key>>16) & 0xFF];
+			++counts[3][key>>24];
+		}
+
+		for(unsigned pass = 0; pass < 4; ++pass)
+		{
+			array<size_t, 256>& digit_counts = counts[pass];
+			if(*max_element(digit_counts.begin(), digit_counts.end()) == size)
+			{
+				continue;
+			}
+			//counts become the first position of each digit
+			size_t position = 0;
+			for(size_t& count : digit_counts)
+			{
+				size_t digit_count = count;
+				count = position;
+				position += digit_count;
+			}
+			unsigned shift = 8*pass;
+			for(uint32_t key : keys)
+			{
+				buffer[digit_counts[(key>>shift) & 0xFF]++] = key;
+			}
+			keys.swap(buffer);
+		}
+
+		for(size_t idx = 0; idx < size; ++idx)
+		{
+			values[idx] = static_cast<int>(keys[idx] ^ 0x80000000u);
+		}
+	}
+
+	//exact max sum of arr[i]*i: counting path for narrow ranges, radix sort and blocked dot product otherwise. 'values' is sorted by the radix path
+	__int128 compute_max_sum_fast(vector<int>& values, unsigned workers = parallel_helpers::workers_count())
+	{
+		if(values.empty())
+		{
+			return 0;
+		}
+
+		auto extremes = minmax_element(values.begin(), values.end());
+		int64_t range = static_cast<int64_t>(*extremes.second) - *extremes.first + 1;
+		if(range <= max_counting_range)
+		{
+			return max_sum_counting(values, *extremes.first, range, workers);
+		}
+
+		radix_sort(values);
+		return ramp_dot_product(values.data(), values.size(), workers);
+	}
+
+	string to_string(__int128 value)
+	{
+		unsigned __int128 magnitude = value < 0 ? -static_cast<unsigned __int128>(value) : static_cast<unsigned __int128>(value);
+		string digits;
+		do
+		{
+			digits.push_back(static_cast<char>('0' + static_cast<int>(magnitude%10)));
+			magnitude /= 10;
+		}
+		while(magnitude != 0);
+		if(value < 0)
+		{
+			digits.push_back('-');
+		}
+		return string(digits.rbegin(), digits.rend());
+	}
+
+	//multiset of values from a known universe, maintaining the max sum of sorted[i]*i under insertions and deletions
+	class dynamic_rank_sum
+	{
+	public:
+		explicit dynamic_rank_sum(vector<int> universe)
+		{
+			sort(universe.begin(), universe.end());
+			universe.erase(unique(universe.begin(), universe.end()), universe.end());
+			values.swap(universe);
+			//Fenwick trees are 1 based
+			counts.assign(values.size() + 1, 0);
+			sums.assign(values.size() + 1, 0);
+		}
+
+		//false if the value is not part of the universe
+		bool insert(int value)
+		{
+			size_t position = compressed(value);
+			if(position == 0)
+			{
+				return false;
+			}
+			uint64_t rank = prefix(counts, position);
+			int64_t greater_sum = total_values - prefix(sums, position);
+			total += static_cast<__int128>(value)*rank + greater_sum;
+			update(position, 1, value);
+			return true;
+		}
+
+		//removes one occurrence, the last one among its equals. False if the value is not in the multiset
+		bool erase(int value)
+		{
+			size_t position = compressed(value);
+			if(position == 0 || prefix(counts, position) == prefix(counts, position - 1))
+			{
+				return false;
+			}
+			update(position, -1, -static_cast<int64_t>(value));
+			uint64_t rank = prefix(counts, position);
+			int64_t greater_sum = total_values - prefix(sums, position);
+			total -= static_cast<__int128>(value)*rank + greater_sum;
+			return true;
+		}
+
+		__int128 max_sum() const
+		{
+			return total;
+		}
+
+	private:
+		//1 based position of the value in the universe, 0 if it is not there
+		size_t compressed(int value) const
+		{
+			auto found = lower_bound(values.begin(), values.end(), value);
+			return found != values.end() && *found == value ? static_cast<size_t>(found - values.begin()) + 1 : 0;
+		}
+
+		template<typename T>
+		static T prefix(const vector<T>& tree, size_t position)
+		{
+			T result = 0;
+			for(; position > 0; position &= position - 1)
+			{
+				result += tree[position];
+			}
+			return result;
+		}
+
+		void update(size_t position, int64_t count, int64_t value)
+		{
+			total_values += value;
+			for(; position < counts.size(); position += position & (~position + 1))
+			{
+				counts[position] += count;
+				sums[position] += value;
+			}
+		}
+
+		vector<int> values;
+		vector<int64_t> counts;
+		vector<int64_t> sums;
+		int64_t total_values = 0;
+		__int128 total = 0;
+	};
+
+	//random insertions and deletions on a multiset, checked at the end against a full recomputation
+	void benchmark_dynamic(size_t universe_size, size_t operations)
+	{
+		vector<int> universe(universe_size);
+		benchmark_helpers::random_generator generator;
+		for(int& value : universe)
+		{
+			value = static_cast<int>(generator.next());
+		}
+
+		dynamic_rank_sum multiset(universe);
+		vector<int> inserted;
+		double elapsed = benchmark_helpers::seconds([&]
+			{
+				for(size_t operation = 0; operation < operations; ++operation)
+				{
+					//2 insertions for each deletion, so the multiset grows
+					if(generator.next(3) != 0 || inserted.empty())
+					{
+						int value = universe[generator.next(universe_size)];
+						multiset.insert(value);
+						inserted.push_back(value);
+					}
+					else
+					{
+						size_t victim = generator.next(inserted.size());
+						multiset.erase(inserted[victim]);
+						inserted[victim] = inserted.back();
+						inserted.pop_back();
+					}
+				}
+			});
+
+		__int128 recomputed = compute_max_sum_fast(inserted);
+		cout<<"benchmark for "<<operations<<" insertions/deletions over "<<universe_size<<" distinct values: "<<elapsed<<" s ("<<elapsed/operations*1e9<<" ns per update), "
+			<<inserted.size()<<" values left, sum "<<to_string(multiset.max_sum())<<(multiset.max_sum() == recomputed ? " (same as recomputed)" : " (different from recomputed)")<<endl;
+	}
+
+	//random values with at most max_value in absolute value: the fast path on 'size' values, the comparison sort on 'sort_size' of them
+	void benchmark(size_t size, size_t sort_size, uint32_t max_value)
+	{
+		vector<int> values(size);
+		benchmark_helpers::random_generator generator;
+		for(int& value : values)
+		{
+			value = static_cast<int>(static_cast<int64_t>(generator.next(2*static_cast<uint64_t>(max_value) + 1)) - max_value);
+		}
+
+		vector<vector<int>> sort_input{vector<int>(values.begin(), values.begin() + sort_size)};
+		vector<int> sort_sums;
+		double sort_time = benchmark_helpers::seconds([&]{compute_max_sum(sort_input, sort_sums);});
+
+		vector<int> check(values.begin(), values.begin() + sort_size);
+		__int128 check_sum = compute_max_sum_fast(check);
+
+		__int128 sum = 0;
+		double fast_time = benchmark_helpers::seconds([&]{sum = compute_max_sum_fast(values);});
+
+		cout<<"benchmark for values in ["<<-static_cast<int64_t>(max_value)<<", "<<max_value<<"]"<<endl;
+		cout<<"    comparison sort, "<<sort_size<<" values: "<<sort_sums[0]<<" (32 bits) in "<<sort_time<<" s, fast path on the same values: "<<to_string(check_sum)<<endl;
+		cout<<"    fast path, "<<size<<" values: "<<to_string(sum)<<" in "<<fast_time<<" s ("<<size/fast_time/1e6<<" million values/s)"<<endl;
+	}
+
 	void print_sums(const vector<int>& sums)
 	{
 		for(vector<int>::const_iterator it=sums.cbegin(), end=sums.cend(); it!=end; ++it)
@@ -87,5 +406,37 @@ void max_sum_elementMultipliedWithIndex()
 	
 	maxSumElemIndex::compute_max_sum(input_vectors, sums);
 	maxSumElemIndex::print_sums(sums);
+
+	for(size_t idx = 0, size = input_vectors.size(); idx < size; ++idx)
+	{
+		std::cout<<"max sum with counting sort for vector "<<idx+1<<" "<<maxSumElemIndex::to_string(maxSumElemIndex::compute_max_sum_fast(input_vectors[idx]))<<std::endl;
+	}
+
+	//the values of the first vector inserted one by one, then erased in the same order
+	if(!input_vectors.empty())
+	{
+		maxSumElemIndex::dynamic_rank_sum multiset(input_vectors[0]);
+		std::cout<<"dynamic max sum while inserting:";
+		for(int value : input_vectors[0])
+		{
+			multiset.insert(value);
+			std::cout<<" "<<maxSumElemIndex::to_string(multiset.max_sum());
+		}
+		std::cout<<std::endl<<"dynamic max sum while erasing:";
+		for(int value : input_vectors[0])
+		{
+			multiset.erase(value);
+			std::cout<<" "<<maxSumElemIndex::to_string(multiset.max_sum());
+		}
+		std::cout<<std::endl;
+	}
+}
+
+void max_sum_elementMultipliedWithIndex_benchmark()
+{
+	//narrow range (counting path), then the full int range (radix path)
+	maxSumElemIndex::benchmark(100000000, 10000000, 1000);
+	maxSumElemIndex::benchmark(100000000, 10000000, 2147483647u);
+	maxSumElemIndex::benchmark_dynamic(1000000, 10000000);
 }
 
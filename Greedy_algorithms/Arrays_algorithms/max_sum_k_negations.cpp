@@ -1,4 +1,6 @@
 #include "array_greedy_algorithms.hpp"
+#include "../benchmark_helpers.hpp"
+#include <cstdint>
 
 /* Maximize array sum after k-negations
  * 
@@ -8,6 +10,19 @@
  * Approach: As the array's element can have negative, positive and zero values, the maximum sum can be obtained if the first minimum k elements are negated. Concretely, the zeroes will stay as they are while
  * 			the negative numbers are turned positive. If the number of negatives is < k, then the zeroes are considered. If still k values were not reached, then the smallest positives are turned negative. Thus, sort
  * 			array in ascending order and engate first k values.
+ *
+ * 			Sorting (or draining a heap) is O(NlogN), while only the k smallest values matter. If the same element is allowed to be negated more than once, there are 2 cases:
+ * 				- k <= number of negatives: the k smallest values are negated. nth_element moves them at the front of the array in O(N) expected time, without ordering them, so
+ * 				  sum = sum of all values - 2 * sum of the first k values
+ * 				- k > number of negatives: all negatives are negated, which gives the sum of absolute values. The remaining negations cancel each other in pairs on the smallest absolute value,
+ * 				  so if their number is odd, 2 * the smallest absolute value is substracted. No selection is needed here, only one pass over the array.
+ * 			Note the 2nd case differs from compute_max_sum, which negates k distinct elements, so it turns the smallest positives negative instead of negating the smallest absolute value back and forth.
+ *
+ * 			When the same array is queried for many values of k, it is sorted once (negation_index) and the prefix sums of the sorted values are stored. Then, for any k:
+ * 				- k <= number of negatives: sum = total sum - 2 * prefix_sums[k]
+ * 				- otherwise: sum = sum of absolute values, minus 2 * the smallest absolute value if k - number of negatives is odd. The smallest absolute value is next to the border between
+ * 				  negatives and non negatives in the sorted array.
+ * 			so each query is O(1).
  */ 
 
 namespace maxSumKNeg
@@ -84,6 +99,171 @@ namespace maxSumKNeg
 		}
 	}
 	
+	//same as above for k <= number of negatives. For larger k, the extra negations are applied on the smallest absolute value. 'values' is used as scratch memory
+	int64_t compute_max_sum_selection(vector<int>& values, size_t k)
+	{
+		//there is nothing to negate, whatever k is
+		if(values.empty())
+		{
+			return 0;
+		}
+
+		//single pass, without branches, which the compiler vectorizes. The absolute values are computed on 64 bits, as -INT_MIN does not fit in an int
+		size_t count_negatives = 0;
+		int64_t sum = 0, sum_absolute = 0;
+		int64_t min_absolute = numeric_limits<int64_t>::max();
+		for(int value : values)
+		{
+			count_negatives += value < 0;
+			sum += value;
+			int64_t absolute = value < 0 ? -static_cast<int64_t>(value) : value;
+			sum_absolute += absolute;
+			min_absolute = min(min_absolute, absolute);
+		}
+
+		if(k > count_negatives)
+		{
+			return (k - count_negatives)%2 == 0 ? sum_absolute : sum_absolute - 2*min_absolute;
+		}
+
+		//the k smallest values end up in [0, k), in any order
+		if(k > 0 && k < values.size())
+		{
+			nth_element(values.begin(), values.begin() + k, values.end());
+		}
+		int64_t sum_negated = 0;
+		for(size_t idx = 0; idx < k; ++idx)
+		{
+			sum_negated += values[idx];
+		}
+		return sum - 2*sum_negated;
+	}
+
+	//sorted copy of an array, with prefix sums, answering the max sum after k negations (same rules as compute_max_sum_selection) for any k in O(1)
+	class negation_index
+	{
+	public:
+		explicit negation_index(vector<int> values)
+		{
+			sort(values.begin(), values.end());
+
+			//prefix_sums[idx] is the sum of the idx smallest values
+			prefix_sums.assign(values.size() + 1, 0);
+			for(size_t idx = 0, size = values.size(); idx < size; ++idx)
+			{
+				prefix_sums[idx+1] = prefix_sums[idx] + values[idx];
+			}
+
+			count_negatives = static_cast<size_t>(lower_bound(values.begin(), values.end(), 0) - values.begin());
+			//sum of absolute values = (sum of non negatives) - (sum of negatives)
+			sum_absolute = prefix_sums.back() - 2*prefix_sums[count_negatives];
+
+			//the smallest absolute value is either the largest negative or the smallest non negative
+			min_absolute = numeric_limits<int64_t>::max();
+			if(count_negatives > 0)
+			{
+				min_absolute = -static_cast<int64_t>(values[count_negatives-1]);
+			}
+			if(count_negatives < values.size())
+			{
+				min_absolute = min<int64_t>(min_absolute, values[count_negatives]);
+			}
+		}
+
+		int64_t max_sum(size_t k) const
+		{
+			//there is nothing to negate, and min_absolute is not set
+			if(prefix_sums.size() == 1)
+			{
+				return 0;
+			}
+			if(k <= count_negatives)
+			{
+				return prefix_sums.back() - 2*prefix_sums[k];
+			}
+			return (k - count_negatives)%2 == 0 ? sum_absolute : sum_absolute - 2*min_absolute;
+		}
+
+		void max_sums(const vector<size_t>& ks, vector<int64_t>& sums) const
+		{
+			sums.resize(ks.size());
+			for(size_t idx = 0, size = ks.size(); idx < size; ++idx)
+			{
+				sums[idx] = max_sum(ks[idx]);
+			}
+		}
+
+	private:
+		vector<int64_t> prefix_sums;
+		size_t count_negatives;
+		int64_t sum_absolute;
+		int64_t min_absolute;
+	};
+
+	//the same array queried for many values of k: one index against one selection per k
+	void benchmark_queries(size_t size, size_t queries)
+	{
+		vector<int> values(size);
+		benchmark_helpers::random_generator generator;
+		for(int& value : values)
+		{
+			value = static_cast<int>(generator.next(2001)) - 1000;
+		}
+		vector<size_t> ks(queries);
+		for(size_t& k : ks)
+		{
+			k = generator.next(size + 1);
+		}
+
+		vector<int64_t> sums;
+		double index_time = benchmark_helpers::seconds([&]
+			{
+				negation_index index(values);
+				index.max_sums(ks, sums);
+			});
+
+		size_t mismatches = 0;
+		double selection_time = benchmark_helpers::seconds([&]
+			{
+				vector<int> scratch;
+				for(size_t idx = 0; idx < queries; ++idx)
+				{
+					scratch = values;
+					mismatches += compute_max_sum_selection(scratch, ks[idx]) != sums[idx];
+				}
+			});
+		cout<<"benchmark for "<<queries<<" values of k on "<<size<<" values: index (sort included) in "<<index_time<<" s, selection per k in "<<selection_time<<" s, "
+			<<mismatches<<" different results"<<endl;
+	}
+
+	//random values in [-1000, 1000]: the selection path for k below and above the negatives count, against the heap for a smaller size
+	void benchmark(size_t size, size_t heap_size)
+	{
+		vector<int> values(size);
+		benchmark_helpers::random_generator generator;
+		for(int& value : values)
+		{
+			value = static_cast<int>(generator.next(2001)) - 1000;
+		}
+
+		cout<<"benchmark for "<<size<<" values"<<endl;
+		for(size_t k : {size/4, size})
+		{
+			vector<int> scratch(values);
+			int64_t sum = 0;
+			double elapsed = benchmark_helpers::seconds([&]{sum = compute_max_sum_selection(scratch, k);});
+			cout<<"    selection, k = "<<k<<": "<<sum<<" in "<<elapsed<<" s"<<endl;
+		}
+
+		//the heap pops all the values, so it is timed on fewer of them. Its sum is a 32 bits int, which overflows at this size
+		vector<pair<vector<int>, unsigned>> heap_input{make_pair(vector<int>(values.begin(), values.begin() + heap_size), static_cast<unsigned>(heap_size/4))};
+		vector<pair<int, unsigned>> heap_sums;
+		double heap_time = benchmark_helpers::seconds([&]{compute_max_sum(heap_input, heap_sums);});
+		int64_t sum = 0;
+		double selection_time = benchmark_helpers::seconds([&]{sum = compute_max_sum_selection(heap_input[0].first, heap_size/4);});
+		cout<<"    "<<heap_size<<" values, k = "<<heap_size/4<<": heap "<<heap_sums[0].first<<" in "<<heap_time<<" s, selection "<<sum<<" in "<<selection_time<<" s"<<endl;
+	}
+
 	void print_sums(const vector<pair<int, unsigned>>& sums)
 	{
 		for(vector<pair<int, unsigned>>::const_iterator it=sums.cbegin(), end=sums.cend(); it!=end; ++it)
@@ -102,4 +282,41 @@ void max_sum_k_negations()
 	
 	maxSumKNeg::compute_max_sum(input_vectors, sums);
 	maxSumKNeg::print_sums(sums);
+
+	//negations may repeat on the same element here, so the vectors with k > number of negatives get greater sums
+	for(size_t idx = 0, size = input_vectors.size(); idx < size; ++idx)
+	{
+		std::vector<int> scratch(input_vectors[idx].first);
+		std::cout<<"max sum with selection for vector "<<idx+1<<" "<<maxSumKNeg::compute_max_sum_selection(scratch, input_vectors[idx].second)<<" after negations: "<<input_vectors[idx].second<<std::endl;
+	}
+
+	//one index per vector, queried for every k from 0 to the vector's size + 1
+	for(size_t idx = 0, size = input_vectors.size(); idx < size; ++idx)
+	{
+		maxSumKNeg::negation_index index(input_vectors[idx].first);
+		std::vector<size_t> ks;
+		for(size_t k = 0; k <= input_vectors[idx].first.size() + 1; ++k)
+		{
+			ks.push_back(k);
+		}
+		std::vector<int64_t> index_sums;
+		index.max_sums(ks, index_sums);
+		std::cout<<"max sums for vector "<<idx+1<<" with k = 0, 1, ...:";
+		for(int64_t sum : index_sums)
+		{
+			std::cout<<" "<<sum;
+		}
+		std::cout<<std::endl;
+	}
+
+	//edge cases: no values at all, and the one value whose absolute value does not fit in an int
+	std::vector<int> empty_values, min_values{std::numeric_limits<int>::min()};
+	std::cout<<"max sum with selection for an empty vector, k = 1: "<<maxSumKNeg::compute_max_sum_selection(empty_values, 1)<<", with the index: "<<maxSumKNeg::negation_index(empty_values).max_sum(1)<<std::endl;
+	std::cout<<"max sum with selection for {INT_MIN}, k = 2: "<<maxSumKNeg::compute_max_sum_selection(min_values, 2)<<std::endl;
+}
+
+void max_sum_k_negations_benchmark()
+{
+	maxSumKNeg::benchmark(100000000, 10000000);
+	maxSumKNeg::benchmark_queries(1000000, 200);
 }
@@ -66,7 +66,7 @@ namespace minSum_prodsElements
 
 		std::priority_queue<pair<int, size_t>, vector<pair<int, size_t>>, decltype(cmp)> pqueue(cmp);
 		
-		int sum{0}, default_product, changed_product;
+		int sum{0}, default_product, changed_product{0};
 		
 		for(vector<int>::size_type idx{0}, dim = input_vectors.first.size(); idx<dim; ++idx)
 		{
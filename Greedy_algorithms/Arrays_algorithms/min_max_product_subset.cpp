@@ -0,0 +1,434 @@
+#include "array_greedy_algorithms.hpp"
+#include "../parallel_helpers.hpp"
+#include "../benchmark_helpers.hpp"
+#include <cstdint>
+
+/* Minimum and maximum product subsets of an array, in a single pass
+ *
+ * Problem description: Same as min product subset and max product subset, but both results are computed at once, for arrays large enough that the product does not fit in 32 bits
+ * 						(nor in any fixed size integer).
+ *
+ * Approach: Both algorithms need the same data from the array: the count of zeroes, the count of negatives, the largest negative value, the smallest positive value and the product of the non zero values.
+ * 			 Thus, they are gathered in a single pass (product_stats) and both answers are derived from them:
+ * 						- min: 0 if there are only zeroes and positives (with at least a zero), the smallest positive if there are only positives, the product if the negatives count is odd,
+ * 						  otherwise the product divided by the largest negative
+ * 						- max: 0 if there are only zeroes or a single negative among zeroes, the value itself for a single negative alone, the product divided by the largest negative if the negatives count
+ * 						  is odd, otherwise the product
+ * 			 The array is processed in blocks: the counts and the extremes of a block are computed in a branchless loop with a fixed number of iterations, which the compiler vectorizes, then the
+ * 			 block's values are multiplied into the product.
+ * 			 As the product grows by up to 31 bits with each value, its representation is a template parameter:
+ * 						- exact_product: 128 bits integer, which reports an overflow instead of wrapping around
+ * 						- log_product: sign and magnitude, the magnitude being kept as a double mantissa and a separate binary exponent, so it never overflows
+ * 						- modular_product: product modulo the prime 2^61-1. Division by the largest negative is a multiplication by its modular inverse
+ * 			 The stats of 2 ranges combine by adding the counts, taking the extremes and multiplying the products, so large arrays are split in ranges, one per thread, and the stats are reduced at the end.
+ */
+
+namespace min_max_prod
+{
+	using namespace std;
+
+	//exact product, as long as it fits in 128 bits
+	struct exact_product
+	{
+		__int128 value = 1;
+		bool overflow = false;
+
+		static exact_product of(int factor)
+		{
+			exact_product result;
+			result.value = factor;
+			return result;
+		}
+
+		void multiply(int factor)
+		{
+			//once overflown, the value is meaningless, so skip the checked multiplication
+			if(!overflow)
+			{
+				overflow = __builtin_mul_overflow(value, static_cast<__int128>(factor), &value);
+			}
+		}
+
+		void multiply(const exact_product& other)
+		{
+			overflow = overflow || other.overflow || __builtin_mul_overflow(value, other.value, &value);
+		}
+
+		void divide(int divisor)
+		{
+			value /= divisor;
+		}
+	};
+
+	ostream& operator<<(ostream& out, const exact_product& product)
+	{
+		if(product.overflow)
+		{
+			return out<<"overflow (more than 127 bits)";
+		}
+
+		unsigned __int128 magnitude = product.value < 0 ? -static_cast<unsigned __int128>(product.value) : static_cast<unsigned __int128>(product.value);
+		string digits;
+		do
+		{
+			digits.push_back(static_cast<char>('0' + static_cast<int>(magnitude%10)));
+			magnitude /= 10;
+		}
+		while(magnitude != 0);
+		if(product.value < 0)
+		{
+			digits.push_back('-');
+		}
+		return out<<string(digits.rbegin(), digits.rend());
+	}
+
+	//sign * scale * 2^exponent
+	struct log_product
+	{
+		bool negative = false;
+		double scale = 1;
+		int64_t exponent = 0;
+
+		static log_product of(int factor)
+		{
+			log_product result;
+			result.multiply(factor);
+			return result;
+		}
+
+		void multiply(int factor)
+		{
+			negative = negative != (factor < 0);
+			scale *= abs(static_cast<double>(factor));
+			//|factor| < 2^31, so renormalizing above 2^800 keeps the scale far from the double's limit
+			if(scale > 0x1p800)
+			{
+				normalize();
+			}
+		}
+
+		void multiply(log_product other)
+		{
+			normalize();
+			other.normalize();
+			negative = negative != other.negative;
+			scale *= other.scale;
+			exponent += other.exponent;
+		}
+
+		void divide(int divisor)
+		{
+			negative = negative != (divisor < 0);
+			scale /= abs(static_cast<double>(divisor));
+		}
+
+		void normalize()
+		{
+			int scale_exponent;
+			scale = frexp(scale, &scale_exponent);
+			exponent += scale_exponent;
+		}
+
+		double log2_magnitude() const
+		{
+			return log2(scale) + static_cast<double>(exponent);
+		}
+	};
+
+	//printed in scientific notation, as the number itself can have millions of digits
+	ostream& operator<<(ostream& out, const log_product& product)
+	{
+		if(product.scale == 0)
+		{
+			return out<<0;
+		}
+		double log10_magnitude = product.log2_magnitude()*log10(2.0);
+		double exponent = floor(log10_magnitude);
+		return out<<(product.negative ? "-" : "")<<pow(10.0, log10_magnitude - exponent)<<"e"<<static_cast<int64_t>(exponent);
+	}
+
+	//product modulo 2^61-1. Every |int| is below the modulo, so a non zero value always has an inverse
+	struct modular_product
+	{
+		static const uint64_t modulo = (uint64_t{1}<<61) - 1;
+		uint64_t value = 1;
+
+		//a negative factor becomes modulo + factor. The mask avoids a branch, as the signs of the values are random
+		static uint64_t reduce(int factor)
+		{
+			return static_cast<uint64_t>(static_cast<int64_t>(factor)) + (modulo & (uint64_t{0} - static_cast<uint64_t>(factor < 0)));
+		}
+
+		//for a Mersenne prime, x mod (2^61-1) = (x>>61) + (x & (2^61-1)), followed by at most one subtraction
+		static uint64_t multiply_modulo(uint64_t lhs, uint64_t rhs)
+		{
+			unsigned __int128 product = static_cast<unsigned __int128>(lhs)*rhs;
+			uint64_t result = static_cast<uint64_t>(product & modulo) + static_cast<uint64_t>(product>>61);
+			return result >= modulo ? result - modulo : result;
+		}
+
+		static modular_product of(int factor)
+		{
+			modular_product result;
+			result.value = reduce(factor);
+			return result;
+		}
+
+		void multiply(int factor)
+		{
+			value = multiply_modulo(value, reduce(factor));
+		}
+
+		void multiply(const modular_product& other)
+		{
+			value = multiply_modulo(value, other.value);
+		}
+
+		//multiply by divisor^(modulo-2), which is its inverse (Fermat's little theorem)
+		void divide(int divisor)
+		{
+			uint64_t base = reduce(divisor), inverse = 1;
+			for(uint64_t power = modulo - 2; power != 0; power >>= 1)
+			{
+				if(power & 1)
+				{
+					inverse = multiply_modulo(inverse, base);
+				}
+				base = multiply_modulo(base, base);
+			}
+			value = multiply_modulo(value, inverse);
+		}
+	};
+
+	ostream& operator<<(ostream& out, const modular_product& product)
+	{
+		return out<<product.value<<" (mod 2^61-1)";
+	}
+
+	template<typename Product>
+	struct product_stats
+	{
+		size_t count = 0;
+		size_t count_zeroes = 0;
+		size_t count_negatives = 0;
+		int max_negative = numeric_limits<int>::min();
+		int min_positive = numeric_limits<int>::max();
+		//product of all the non zero values
+		Product product;
+
+		void combine(const product_stats& other)
+		{
+			count += other.count;
+			count_zeroes += other.count_zeroes;
+			count_negatives += other.count_negatives;
+			max_negative = max(max_negative, other.max_negative);
+			min_positive = min(min_positive, other.min_positive);
+			product.multiply(other.product);
+		}
+	};
+
+	template<typename Product>
+	struct subset_products
+	{
+		Product min_product;
+		Product max_product;
+	};
+
+	template<typename Product>
+	product_stats<Product> scan(const int* values, size_t size)
+	{
+		const size_t block = 256;
+		product_stats<Product> stats;
+		stats.count = size;
+		//4 independent products, so the multiplications of neighbouring values do not wait for each other. They are combined at the end
+		Product lanes[4];
+
+		for(size_t first = 0; first < size; first += block)
+		{
+			size_t last = min(first + block, size);
+
+			//counts and extremes, without branches, so the loop is vectorized
+			size_t count_zeroes = 0, count_negatives = 0;
+			int max_negative = numeric_limits<int>::min(), min_positive = numeric_limits<int>::max();
+			for(size_t idx = first; idx < last; ++idx)
+			{
+				int value = values[idx];
+				count_zeroes += value == 0;
+				count_negatives += value < 0;
+				max_negative = max(max_negative, value < 0 ? value : numeric_limits<int>::min());
+				min_positive = min(min_positive, value > 0 ? value : numeric_limits<int>::max());
+			}
+			stats.count_zeroes += count_zeroes;
+			stats.count_negatives += count_negatives;
+			stats.max_negative = max(stats.max_negative, max_negative);
+			stats.min_positive = min(stats.min_positive, min_positive);
+
+			//zeroes are skipped from the product by multiplying with 1 instead
+			size_t idx = first;
+			for(; idx + 4 <= last; idx += 4)
+			{
+				for(size_t lane = 0; lane < 4; ++lane)
+				{
+					lanes[lane].multiply(values[idx + lane] != 0 ? values[idx + lane] : 1);
+				}
+			}
+			for(; idx < last; ++idx)
+			{
+				lanes[0].multiply(values[idx] != 0 ? values[idx] : 1);
+			}
+		}
+
+		stats.product = lanes[0];
+		for(size_t lane = 1; lane < 4; ++lane)
+		{
+			stats.product.multiply(lanes[lane]);
+		}
+		return stats;
+	}
+
+	//the ranges are scanned in parallel, then their stats are combined in order
+	template<typename Product>
+	product_stats<Product> scan_parallel(const vector<int>& values, unsigned workers = parallel_helpers::workers_count())
+	{
+		vector<product_stats<Product>> partial(max(workers, 1u));
+		parallel_helpers::parallel_for_ranges(values.size(), [&](size_t first, size_t last, unsigned worker)
+			{
+				partial[worker] = scan<Product>(values.data() + first, last - first);
+			}, workers);
+
+		product_stats<Product> stats;
+		for(const product_stats<Product>& range_stats : partial)
+		{
+			stats.combine(range_stats);
+		}
+		return stats;
+	}
+
+	template<typename Product>
+	subset_products<Product> derive_products(const product_stats<Product>& stats)
+	{
+		subset_products<Product> result{stats.product, stats.product};
+		size_t non_zeroes = stats.count - stats.count_zeroes;
+
+		//min product subset
+		if(non_zeroes == 0 || (stats.count_negatives == 0 && stats.count_zeroes > 0))
+		{
+			result.min_product = Product::of(0);
+		}
+		else if(stats.count_negatives == 0)
+		{
+			result.min_product = Product::of(stats.min_positive);
+		}
+		else if(stats.count_negatives%2 == 0)
+		{
+			result.min_product.divide(stats.max_negative);
+		}
+
+		//max product subset
+		if(non_zeroes == 0 || (stats.count_negatives == 1 && non_zeroes == 1 && stats.count_zeroes > 0))
+		{
+			result.max_product = Product::of(0);
+		}
+		else if(stats.count_negatives == 1 && non_zeroes == 1)
+		{
+			result.max_product = Product::of(stats.max_negative);
+		}
+		else if(stats.count_negatives%2 == 1)
+		{
+			result.max_product.divide(stats.max_negative);
+		}
+
+		return result;
+	}
+
+	void read_input_vectors(vector<vector<int>>& input_vectors)
+	{
+		ifstream file;
+		//use same input vectors as with min_prod algorithm
+		file.open("min_prod.txt", ios::in);
+
+		string line;
+		int value;
+		vector<int> temp;
+
+		while(getline(file, line))
+		{
+			//erase previously read vector
+			temp.clear();
+
+			//treat each line like a stream of values, instead of string object
+			istringstream iss(line);
+
+			cout<<"vector values: ";
+			//parse the string into integers
+			while(iss>>value)
+			{
+				cout<<value<<" ";
+				//push the read data into the used data structure
+				temp.push_back(value);
+			}
+			cout<<endl;
+			input_vectors.push_back(temp);
+		}
+
+		file.close();
+	}
+
+	template<typename Product>
+	void print_products(const char* name, const vector<vector<int>>& input_vectors)
+	{
+		cout<<name<<endl;
+		for(size_t idx = 0, size = input_vectors.size(); idx < size; ++idx)
+		{
+			subset_products<Product> result = derive_products(scan<Product>(input_vectors[idx].data(), input_vectors[idx].size()));
+			cout<<"min/max product of vector "<<idx+1<<" "<<result.min_product<<" / "<<result.max_product<<endl;
+		}
+	}
+
+	//one representation, on one thread and on all of them
+	template<typename Product>
+	void time_product(const char* name, const vector<int>& values)
+	{
+		for(unsigned workers : {1u, parallel_helpers::workers_count()})
+		{
+			subset_products<Product> result;
+			double elapsed = benchmark_helpers::seconds([&]{result = derive_products(scan_parallel<Product>(values, workers));});
+			cout<<"    "<<name<<", "<<workers<<" threads: min "<<result.min_product<<", max "<<result.max_product<<" in "<<elapsed<<" s"<<endl;
+		}
+	}
+
+	//random values in [-max_value, max_value], then time each representation
+	void benchmark(size_t size, int max_value)
+	{
+		vector<int> values(size);
+		benchmark_helpers::random_generator generator;
+		for(int& value : values)
+		{
+			value = static_cast<int>(generator.next(2*static_cast<uint64_t>(max_value) + 1)) - max_value;
+		}
+
+		cout<<"benchmark for "<<size<<" values in ["<<-max_value<<", "<<max_value<<"]"<<endl;
+		time_product<exact_product>("exact", values);
+		time_product<log_product>("log domain", values);
+		time_product<modular_product>("modular", values);
+	}
+}
+
+void min_max_product_subset()
+{
+	std::vector<std::vector<int>> input_vectors;
+
+	min_max_prod::read_input_vectors(input_vectors);
+
+	min_max_prod::print_products<min_max_prod::exact_product>("exact", input_vectors);
+	min_max_prod::print_products<min_max_prod::log_product>("log domain", input_vectors);
+	min_max_prod::print_products<min_max_prod::modular_product>("modular", input_vectors);
+}
+
+void min_max_product_subset_benchmark()
+{
+	//values in [-1, 1] keep the product in 128 bits, so the 3 representations can be compared on the same results
+	min_max_prod::benchmark(100000000, 1);
+	//with larger values, only the log domain and the modular products are meaningful
+	min_max_prod::benchmark(100000000, 1000);
+}
@@ -0,0 +1,460 @@
+#ifndef BIG_UNSIGNED_HPP
+#define BIG_UNSIGNED_HPP
+
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * Arbitrary precision unsigned integer, kept as a vector of 32 bits limbs, least significant first, without leading zero limbs (so 0 has no limbs at all).
+ * Only the operations needed by the algorithms in this folder are provided: +, -, *, /, %, comparisons, gcd and conversion to decimal string.
+ * 		- values which fit in 64 bits take a fast path using native (or 128 bits) arithmetic
+ * 		- multiplication is schoolbook for small operands and Karatsuba once both operands have at least karatsuba_threshold limbs: x*y = z2*B^(2m) + (z1-z2-z0)*B^m + z0, with
+ * 		  z2 = x1*y1, z0 = x0*y0, z1 = (x1+x0)*(y1+y0) => 3 multiplications of half size instead of 4
+ * 		- division is the classic long division (Knuth, algorithm D), estimating each quotient limb from the top 2 limbs of the remainder
+ */
+
+class big_unsigned
+{
+public:
+	typedef std::vector<uint32_t> limbs;
+
+	static const size_t karatsuba_threshold = 32;
+
+	big_unsigned()
+	{
+	}
+
+	big_unsigned(uint64_t value)
+	{
+		assign_u64(value);
+	}
+
+	bool is_zero() const
+	{
+		return digits.empty();
+	}
+
+	bool fits_u64() const
+	{
+		return digits.size() <= 2;
+	}
+
+	uint64_t to_u64() const
+	{
+		uint64_t value = 0;
+		for(size_t idx = digits.size(); idx > 0; --idx)
+		{
+			value = (value<<32) | digits[idx-1];
+		}
+		return value;
+	}
+
+	size_t limb_count() const
+	{
+		return digits.size();
+	}
+
+	size_t bit_length() const
+	{
+		return digits.empty() ? 0 : 32*(digits.size()-1) + (32 - __builtin_clz(digits.back()));
+	}
+
+	//-1, 0 or 1
+	static int compare(const big_unsigned& lhs, const big_unsigned& rhs)
+	{
+		return compare_limbs(lhs.digits, rhs.digits);
+	}
+
+	friend bool operator==(const big_unsigned& lhs, const big_unsigned& rhs) { return lhs.digits == rhs.digits; }
+	friend bool operator!=(const big_unsigned& lhs, const big_unsigned& rhs) { return lhs.digits != rhs.digits; }
+	friend bool operator<(const big_unsigned& lhs, const big_unsigned& rhs) { return compare(lhs, rhs) < 0; }
+	friend bool operator>(const big_unsigned& lhs, const big_unsigned& rhs) { return compare(lhs, rhs) > 0; }
+	friend bool operator<=(const big_unsigned& lhs, const big_unsigned& rhs) { return compare(lhs, rhs) <= 0; }
+	friend bool operator>=(const big_unsigned& lhs, const big_unsigned& rhs) { return compare(lhs, rhs) >= 0; }
+
+	friend big_unsigned operator+(const big_unsigned& lhs, const big_unsigned& rhs)
+	{
+		big_unsigned result;
+		result.digits = add_limbs(lhs.digits, rhs.digits);
+		return result;
+	}
+
+	//lhs must be >= rhs
+	friend big_unsigned operator-(const big_unsigned& lhs, const big_unsigned& rhs)
+	{
+		big_unsigned result;
+		result.digits = lhs.digits;
+		sub_in_place(result.digits, rhs.digits, 0);
+		return result;
+	}
+
+	friend big_unsigned operator*(const big_unsigned& lhs, const big_unsigned& rhs)
+	{
+		big_unsigned result;
+		if(lhs.fits_u64() && rhs.fits_u64())
+		{
+			unsigned __int128 product = static_cast<unsigned __int128>(lhs.to_u64())*rhs.to_u64();
+			for(; product != 0; product >>= 32)
+			{
+				result.digits.push_back(static_cast<uint32_t>(product));
+			}
+			return result;
+		}
+		result.digits = mul_limbs(lhs.digits, rhs.digits);
+		return result;
+	}
+
+	//divisor must not be 0
+	static void divmod(const big_unsigned& dividend, const big_unsigned& divisor, big_unsigned& quotient, big_unsigned& remainder)
+	{
+		if(dividend.fits_u64() && divisor.fits_u64())
+		{
+			uint64_t lhs = dividend.to_u64(), rhs = divisor.to_u64();
+			quotient.assign_u64(lhs/rhs);
+			remainder.assign_u64(lhs%rhs);
+			return;
+		}
+		divmod_limbs(dividend.digits, divisor.digits, quotient.digits, remainder.digits);
+	}
+
+	friend big_unsigned operator/(const big_unsigned& lhs, const big_unsigned& rhs)
+	{
+		big_unsigned quotient, remainder;
+		divmod(lhs, rhs, quotient, remainder);
+		return quotient;
+	}
+
+	friend big_unsigned operator%(const big_unsigned& lhs, const big_unsigned& rhs)
+	{
+		big_unsigned quotient, remainder;
+		divmod(lhs, rhs, quotient, remainder);
+		return remainder;
+	}
+
+	//Euclid's algorithm. Once both values fit in 64 bits, it continues natively
+	static big_unsigned gcd(big_unsigned lhs, big_unsigned rhs)
+	{
+		big_unsigned quotient, remainder;
+		while(!rhs.is_zero())
+		{
+			if(lhs.fits_u64() && rhs.fits_u64())
+			{
+				uint64_t a = lhs.to_u64(), b = rhs.to_u64();
+				while(b != 0)
+				{
+					uint64_t r = a%b;
+					a = b;
+					b = r;
+				}
+				return big_unsigned(a);
+			}
+			divmod(lhs, rhs, quotient, remainder);
+			lhs.digits.swap(rhs.digits);
+			rhs.digits.swap(remainder.digits);
+		}
+		return lhs;
+	}
+
+	//decimal representation, built 9 digits at a time
+	std::string to_string() const
+	{
+		if(digits.empty())
+		{
+			return "0";
+		}
+
+		limbs value(digits);
+		std::vector<uint32_t> chunks;
+		while(!value.empty())
+		{
+			uint64_t remainder = 0;
+			for(size_t idx = value.size(); idx > 0; --idx)
+			{
+				uint64_t current = (remainder<<32) | value[idx-1];
+				value[idx-1] = static_cast<uint32_t>(current/1000000000u);
+				remainder = current%1000000000u;
+			}
+			trim(value);
+			chunks.push_back(static_cast<uint32_t>(remainder));
+		}
+
+		std::string result = std::to_string(chunks.back());
+		for(size_t idx = chunks.size()-1; idx > 0; --idx)
+		{
+			std::string chunk = std::to_string(chunks[idx-1]);
+			result += std::string(9 - chunk.size(), '0') + chunk;
+		}
+		return result;
+	}
+
+private:
+	void assign_u64(uint64_t value)
+	{
+		digits.clear();
+		for(; value != 0; value >>= 32)
+		{
+			digits.push_back(static_cast<uint32_t>(value));
+		}
+	}
+
+	static void trim(limbs& value)
+	{
+		while(!value.empty() && value.back() == 0)
+		{
+			value.pop_back();
+		}
+	}
+
+	static int compare_limbs(const limbs& lhs, const limbs& rhs)
+	{
+		if(lhs.size() != rhs.size())
+		{
+			return lhs.size() < rhs.size() ? -1 : 1;
+		}
+		for(size_t idx = lhs.size(); idx > 0; --idx)
+		{
+			if(lhs[idx-1] != rhs[idx-1])
+			{
+				return lhs[idx-1] < rhs[idx-1] ? -1 : 1;
+			}
+		}
+		return 0;
+	}
+
+	static limbs add_limbs(const limbs& lhs, const limbs& rhs)
+	{
+		const limbs& longer = lhs.size() >= rhs.size() ? lhs : rhs;
+		const limbs& shorter = lhs.size() >= rhs.size() ? rhs : lhs;
+		limbs result(longer.size() + 1);
+		uint64_t carry = 0;
+		for(size_t idx = 0; idx < longer.size(); ++idx)
+		{
+			carry += static_cast<uint64_t>(longer[idx]) + (idx < shorter.size() ? shorter[idx] : 0);
+			result[idx] = static_cast<uint32_t>(carry);
+			carry >>= 32;
+		}
+		result[longer.size()] = static_cast<uint32_t>(carry);
+		trim(result);
+		return result;
+	}
+
+	//acc += value * B^shift, B = 2^32
+	static void add_in_place(limbs& acc, const limbs& value, size_t shift)
+	{
+		if(acc.size() < value.size() + shift)
+		{
+			acc.resize(value.size() + shift, 0);
+		}
+		uint64_t carry = 0;
+		size_t idx = 0;
+		for(; idx < value.size(); ++idx)
+		{
+			carry += static_cast<uint64_t>(acc[idx+shift]) + value[idx];
+			acc[idx+shift] = static_cast<uint32_t>(carry);
+			carry >>= 32;
+		}
+		for(idx += shift; carry != 0; ++idx)
+		{
+			if(idx == acc.size())
+			{
+				acc.push_back(0);
+			}
+			carry += acc[idx];
+			acc[idx] = static_cast<uint32_t>(carry);
+			carry >>= 32;
+		}
+	}
+
+	//acc -= value * B^shift, acc must be >= value * B^shift
+	static void sub_in_place(limbs& acc, const limbs& value, size_t shift)
+	{
+		int64_t borrow = 0;
+		size_t idx = 0;
+		for(; idx < value.size(); ++idx)
+		{
+			int64_t difference = static_cast<int64_t>(acc[idx+shift]) - value[idx] - borrow;
+			borrow = difference < 0;
+			acc[idx+shift] = static_cast<uint32_t>(difference);
+		}
+		for(idx += shift; borrow != 0; ++idx)
+		{
+			int64_t difference = static_cast<int64_t>(acc[idx]) - borrow;
+			borrow = difference < 0;
+			acc[idx] = static_cast<uint32_t>(difference);
+		}
+		trim(acc);
+	}
+
+	static limbs mul_schoolbook(const limbs& lhs, const limbs& rhs)
+	{
+		if(lhs.empty() || rhs.empty())
+		{
+			return limbs();
+		}
+		limbs result(lhs.size() + rhs.size(), 0);
+		for(size_t idx = 0; idx < lhs.size(); ++idx)
+		{
+			uint64_t carry = 0;
+			for(size_t idy = 0; idy < rhs.size(); ++idy)
+			{
+				carry += static_cast<uint64_t>(lhs[idx])*rhs[idy] + result[idx+idy];
+				result[idx+idy] = static_cast<uint32_t>(carry);
+				carry >>= 32;
+			}
+			result[idx+rhs.size()] = static_cast<uint32_t>(carry);
+		}
+		trim(result);
+		return result;
+	}
+
+	static limbs low_part(const limbs& value, size_t split)
+	{
+		limbs result(value.begin(), value.begin() + std::min(split, value.size()));
+		trim(result);
+		return result;
+	}
+
+	static limbs high_part(const limbs& value, size_t split)
+	{
+		return split >= value.size() ? limbs() : limbs(value.begin() + split, value.end());
+	}
+
+	static limbs mul_limbs(const limbs& lhs, const limbs& rhs)
+	{
+		if(std::min(lhs.size(), rhs.size()) < karatsuba_threshold)
+		{
+			return mul_schoolbook(lhs, rhs);
+		}
+
+		//split both operands at half of the longer one: x = x1*B^split + x0
+		size_t split = std::max(lhs.size(), rhs.size())/2;
+		limbs lhs_low = low_part(lhs, split), lhs_high = high_part(lhs, split);
+		limbs rhs_low = low_part(rhs, split), rhs_high = high_part(rhs, split);
+
+		limbs low = mul_limbs(lhs_low, rhs_low);
+		limbs high = mul_limbs(lhs_high, rhs_high);
+		limbs middle = mul_limbs(add_limbs(lhs_low, lhs_high), add_limbs(rhs_low, rhs_high));
+		sub_in_place(middle, low, 0);
+		sub_in_place(middle, high, 0);
+
+		limbs result(low);
+		add_in_place(result, middle, split);
+		add_in_place(result, high, 2*split);
+		trim(result);
+		return result;
+	}
+
+	//Knuth's algorithm D. divisor must not be 0
+	static void divmod_limbs(const limbs& dividend, const limbs& divisor, limbs& quotient, limbs& remainder)
+	{
+		if(compare_limbs(dividend, divisor) < 0)
+		{
+			remainder = dividend;
+			quotient.clear();
+			return;
+		}
+
+		//single limb divisor: plain long division
+		if(divisor.size() == 1)
+		{
+			limbs result(dividend.size());
+			uint64_t rest = 0;
+			for(size_t idx = dividend.size(); idx > 0; --idx)
+			{
+				uint64_t current = (rest<<32) | dividend[idx-1];
+				result[idx-1] = static_cast<uint32_t>(current/divisor[0]);
+				rest = current%divisor[0];
+			}
+			trim(result);
+			quotient.swap(result);
+			remainder.clear();
+			if(rest != 0)
+			{
+				remainder.push_back(static_cast<uint32_t>(rest));
+			}
+			return;
+		}
+
+		//normalize: shift both values so the divisor's top limb has its highest bit set, which keeps the quotient limb estimations off by at most 2
+		size_t size = divisor.size(), extra = dividend.size() - size;
+		unsigned shift = __builtin_clz(divisor.back());
+		limbs norm_divisor(size), norm_dividend(dividend.size() + 1);
+		for(size_t idx = size-1; idx > 0; --idx)
+		{
+			norm_divisor[idx] = (divisor[idx]<<shift) | (shift ? static_cast<uint32_t>(static_cast<uint64_t>(divisor[idx-1])>>(32-shift)) : 0);
+		}
+		norm_divisor[0] = divisor[0]<<shift;
+		norm_dividend[dividend.size()] = shift ? static_cast<uint32_t>(static_cast<uint64_t>(dividend.back())>>(32-shift)) : 0;
+		for(size_t idx = dividend.size()-1; idx > 0; --idx)
+		{
+			norm_dividend[idx] = (dividend[idx]<<shift) | (shift ? static_cast<uint32_t>(static_cast<uint64_t>(dividend[idx-1])>>(32-shift)) : 0);
+		}
+		norm_dividend[0] = dividend[0]<<shift;
+
+		const uint64_t base = uint64_t{1}<<32;
+		limbs result(extra + 1, 0);
+		for(size_t step = extra + 1; step > 0; --step)
+		{
+			size_t pos = step-1;
+
+			//estimate the quotient limb from the top 2 limbs of the current remainder, then correct it with the next limb
+			uint64_t top = (static_cast<uint64_t>(norm_dividend[pos+size])<<32) | norm_dividend[pos+size-1];
+			uint64_t estimate = top/norm_divisor[size-1];
+			uint64_t rest = top%norm_divisor[size-1];
+			while(estimate >= base || estimate*norm_divisor[size-2] > ((rest<<32) | norm_dividend[pos+size-2]))
+			{
+				--estimate;
+				rest += norm_divisor[size-1];
+				if(rest >= base)
+				{
+					break;
+				}
+			}
+
+			//multiply and subtract
+			int64_t borrow = 0, difference;
+			for(size_t idx = 0; idx < size; ++idx)
+			{
+				uint64_t product = estimate*norm_divisor[idx];
+				difference = static_cast<int64_t>(norm_dividend[idx+pos]) - borrow - static_cast<int64_t>(product & 0xFFFFFFFFu);
+				norm_dividend[idx+pos] = static_cast<uint32_t>(difference);
+				borrow = static_cast<int64_t>(product>>32) - (difference>>32);
+			}
+			difference = static_cast<int64_t>(norm_dividend[pos+size]) - borrow;
+			norm_dividend[pos+size] = static_cast<uint32_t>(difference);
+
+			//the estimation was still 1 too large: add the divisor back
+			if(difference < 0)
+			{
+				--estimate;
+				uint64_t carry = 0;
+				for(size_t idx = 0; idx < size; ++idx)
+				{
+					carry += static_cast<uint64_t>(norm_dividend[idx+pos]) + norm_divisor[idx];
+					norm_dividend[idx+pos] = static_cast<uint32_t>(carry);
+					carry >>= 32;
+				}
+				norm_dividend[pos+size] += static_cast<uint32_t>(carry);
+			}
+			result[pos] = static_cast<uint32_t>(estimate);
+		}
+
+		//denormalize the remainder
+		limbs rest(size);
+		for(size_t idx = 0; idx < size; ++idx)
+		{
+			rest[idx] = (norm_dividend[idx]>>shift) | (shift ? static_cast<uint32_t>(static_cast<uint64_t>(norm_dividend[idx+1])<<(32-shift)) : 0);
+		}
+		trim(rest);
+		trim(result);
+		remainder.swap(rest);
+		quotient.swap(result);
+	}
+
+	limbs digits;
+};
+
+#endif
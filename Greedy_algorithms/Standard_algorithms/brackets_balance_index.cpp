@@ -0,0 +1,235 @@
+#include "standard_greedy_algorithms.hpp"
+#include "../benchmark_helpers.hpp"
+#include <cstdint>
+#include <limits>
+
+/*
+ * Problem description: A large document (for instance, in an editor) contains brackets among other characters. After every edit of a character, it is aimed to know if the brackets are balanced,
+ * 						the minimum number of swaps that would balance them and the position of the first unmatched bracket. Running brackets_swapping over the whole document is O(n) per edit.
+ *
+ * Approach: The brackets are kept in a segment tree. Each node summarizes its range of characters as:
+ * 				- net: the balance of the range ([ is +1, ] is -1, any other character is 0)
+ * 				- min_prefix: the minimum balance reached after a character of the range, relative to the balance before the range
+ * 			 2 neighbouring ranges are summarized as (left.net + right.net, min(left.min_prefix, left.net + right.min_prefix)), so:
+ * 				- an edit changes a leaf and the log(n) summaries above it
+ * 				- the root summarizes the whole document. If net is 0 and min_prefix is >= 0, the document is balanced.
+ * 				- if net is 0, the minimum number of swaps is ceil(-min_prefix/2), as each swap of a ] with a later [ raises the lowest balance by 2. brackets_swapping always swaps with
+ * 				  the next [, so it can do more swaps than this minimum (]][[ is balanced by it in 2 swaps, while swapping the ends needs 1)
+ * 				- the first unmatched ] is the first position where the balance goes negative: going down from the root, the left child is taken if its min_prefix goes below 0, otherwise the right one.
+ * 				  If no ] is unmatched but net > 0, the first unmatched [ comes right after the last position where the balance is 0, found the same way from the right.
+ * 			 So every edit and every query is O(logN).
+ */
+
+namespace brackets_index
+{
+	using namespace std;
+
+	//summary of a range of characters. The empty range has no prefix, so its minimum is "infinite"
+	struct balance_node
+	{
+		int64_t net = 0;
+		int64_t min_prefix = numeric_limits<int64_t>::max()/2;
+	};
+
+	balance_node combine(const balance_node& left, const balance_node& right)
+	{
+		return balance_node{left.net + right.net, min(left.min_prefix, left.net + right.min_prefix)};
+	}
+
+	balance_node leaf(char character)
+	{
+		int64_t step = character == '[' ? 1 : (character == ']' ? -1 : 0);
+		return balance_node{step, step};
+	}
+
+	class balance_index
+	{
+	public:
+		static const size_t npos = static_cast<size_t>(-1);
+
+		explicit balance_index(const string& document)
+			: length(document.size())
+		{
+			leaves = 1;
+			while(leaves < length)
+			{
+				leaves *= 2;
+			}
+
+			//nodes[1] is the root, the children of node idx are 2*idx and 2*idx+1, the leaves start at index 'leaves'
+			nodes.assign(2*leaves, balance_node());
+			for(size_t idx = 0; idx < length; ++idx)
+			{
+				nodes[leaves + idx] = leaf(document[idx]);
+			}
+			for(size_t idx = leaves - 1; idx > 0; --idx)
+			{
+				nodes[idx] = combine(nodes[2*idx], nodes[2*idx+1]);
+			}
+		}
+
+		//replace the character found at 'position'
+		void edit(size_t position, char character)
+		{
+			size_t idx = leaves + position;
+			nodes[idx] = leaf(character);
+			for(idx /= 2; idx > 0; idx /= 2)
+			{
+				nodes[idx] = combine(nodes[2*idx], nodes[2*idx+1]);
+			}
+		}
+
+		bool is_balanced() const
+		{
+			return root().net == 0 && root().min_prefix >= 0;
+		}
+
+		//-1 when the numbers of [ and ] differ, as then no number of swaps can balance the brackets
+		int64_t minimum_swaps() const
+		{
+			if(root().net != 0)
+			{
+				return -1;
+			}
+			int64_t deficit = max<int64_t>(0, -root().min_prefix);
+			return (deficit + 1)/2;
+		}
+
+		//position of the first ] without a matching [ before it or, if there is none, of the first [ without a matching ] after it. npos if all brackets are matched
+		size_t first_unmatched() const
+		{
+			if(root().min_prefix < 0)
+			{
+				//go down to the first leaf where the balance gets below 0
+				size_t idx = 1;
+				int64_t before = 0;
+				while(idx < leaves)
+				{
+					if(before + nodes[2*idx].min_prefix < 0)
+					{
+						idx = 2*idx;
+					}
+					else
+					{
+						before += nodes[2*idx].net;
+						idx = 2*idx+1;
+					}
+				}
+				return idx - leaves;
+			}
+
+			if(root().net == 0)
+			{
+				return npos;
+			}
+
+			//the balance is never negative, so the first unmatched [ follows the last position where the balance is 0. If there is none, the very first character is a [ never closed.
+			//Otherwise, go down from the root, preferring the right child whenever the balance reaches 0 in it
+			if(root().min_prefix > 0)
+			{
+				return 0;
+			}
+			size_t idx = 1;
+			int64_t before = 0;
+			while(idx < leaves)
+			{
+				if(before + nodes[2*idx].net + nodes[2*idx+1].min_prefix <= 0)
+				{
+					before += nodes[2*idx].net;
+					idx = 2*idx+1;
+				}
+				else
+				{
+					idx = 2*idx;
+				}
+			}
+			return idx - leaves + 1;
+		}
+
+	private:
+		const balance_node& root() const
+		{
+			return nodes[1];
+		}
+
+		size_t length;
+		size_t leaves;
+		vector<balance_node> nodes;
+	};
+
+	void print_state(const balance_index& index, const string& document)
+	{
+		size_t unmatched = index.first_unmatched();
+		cout<<document<<"   balanced: "<<(index.is_balanced() ? "yes" : "no")<<", minimum swaps: "<<index.minimum_swaps()<<", first unmatched position: ";
+		if(unmatched == balance_index::npos)
+		{
+			cout<<"none"<<endl;
+		}
+		else
+		{
+			cout<<unmatched<<endl;
+		}
+	}
+
+	//random document of brackets and other characters, then random edits, each followed by the queries
+	void benchmark(size_t size, size_t edits)
+	{
+		string document(size, 'a');
+		benchmark_helpers::random_generator generator;
+		const char characters[] = {'[', ']', 'a', 'a'};
+		for(char& character : document)
+		{
+			character = characters[generator.next(4)];
+		}
+
+		balance_index index{string()};
+		double build_time = benchmark_helpers::seconds([&]{index = balance_index(document);});
+
+		int64_t checksum = 0;
+		double edits_time = benchmark_helpers::seconds([&]
+			{
+				for(size_t edit = 0; edit < edits; ++edit)
+				{
+					char character = characters[generator.next(4)];
+					index.edit(generator.next(size), character);
+					checksum += index.minimum_swaps() + static_cast<int64_t>(index.first_unmatched()%1024);
+				}
+			});
+		cout<<"benchmark for a document of "<<size<<" characters: built in "<<build_time<<" s, "<<edits<<" edits with queries in "<<edits_time<<" s ("
+			<<edits_time/edits*1e9<<" ns per edit), checksum "<<checksum<<endl;
+	}
+}
+
+void brackets_balance_index()
+{
+	std::string document;
+	{
+		std::ifstream file("brackets.txt", std::ios::in);
+		std::getline(file, document);
+	}
+
+	brackets_index::balance_index index(document);
+	brackets_index::print_state(index, document);
+
+	//fix the first line of brackets.txt with edits, one character at a time
+	const std::string edited = "[][][][]";
+	for(size_t idx = 0, size = std::min(document.size(), edited.size()); idx < size; ++idx)
+	{
+		if(document[idx] != edited[idx])
+		{
+			document[idx] = edited[idx];
+			index.edit(idx, edited[idx]);
+			brackets_index::print_state(index, document);
+		}
+	}
+
+	//the number of brackets differs: unmatched [ at the end
+	document[7] = '[';
+	index.edit(7, '[');
+	brackets_index::print_state(index, document);
+}
+
+void brackets_balance_index_benchmark()
+{
+	brackets_index::benchmark(size_t{1}<<26, 10000000);
+}
@@ -1,4 +1,11 @@
 #include "standard_greedy_algorithms.hpp"
+#include "../parallel_helpers.hpp"
+#include "../benchmark_helpers.hpp"
+#include <cstdint>
+#include <cstring>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 /*
  * Problem description: Given an input string containing an equal number of open and closed brackets in a random order ( '[] and ']') it is aimed at finding the minimum number of permutation that would lead to a balanced     *						string, namely all brackets are matching (as in maths)
@@ -15,6 +22,27 @@
  *			 		when swapping.
  *				 - as it is done in the naive approach, the swap is performed when the brackets_counter turn negative. After swapping, this counter is set to 1, likewise the nive approach does. 
  * 				 - both approaches use swap_counter that is incremented when swapping							
+ *
+ *			When only the number of swaps is needed, it can be obtained without the open_brackets_positions array and without modifying the string:
+ *				 - a swap happens at index t only when the counter is 0 before t, so t = 2*(number of [ placed before t) and the [ brought there is the next one in the original order. If it is the i-th [
+ *				   (0 based), it is found at open_brackets_positions[i] > t = 2*i.
+ *				 - conversely, a [ whose position is > 2*i cannot be reached before index 2*i, which then gets a swap
+ *				 - position > 2*i means that, before it, there are more ] than [ in the original string. So the number of swaps is the number of [ before which the balance of the original string is negative
+ *			This only needs the running balance, so it is computed 16 characters at a time (SIMD): each character becomes +1 or -1, the prefix sums inside the block are computed with log2(16) shifted
+ *			additions and the [ whose balance before them is negative are counted from a comparison mask. When the balance at the start of a block is far from 0, the block is decided from its count of [ alone.
+ *
+ *			The rebalanced string also follows from the original balance alone: the i-th [ stays in place if its position is <= 2*i, otherwise it moves at index 2*i. Thus, index t gets a [ if:
+ *				 - it holds a [ and the balance before it is >= 0, or
+ *				 - t is even and the balance after it is negative (a [ is brought there)
+ *			This lets a multi GB string be rebalanced on several threads: the string is split in chunks and each chunk is summarized as (net balance, minimum prefix balance). The summaries compose
+ *			associatively: (a then b) = (a.net + b.net, min(a.min, a.net + b.min)), so a prefix scan over them gives the balance at the start of every chunk. Then each chunk is rewritten independently,
+ *			and a chunk whose balance never goes negative is left untouched.
+ *
+ *			For dumps larger than the memory, the same holds while streaming: the input is read in fixed size buffers, only the balance and the position are carried from a buffer to the next one.
+ *			As the character written at index t depends only on the balances before and after t, the rebalanced buffer can be written out right away, so no queue of pending [ is needed.
+ *
+ *			The swaps of the O(n) approach can also be done in place, with O(1) extra memory: the next [ to be used for a swap is the first [ after both the current index and the last used [.
+ *			So, instead of open_brackets_positions, a single index scans forward for it. It never moves back, thus the whole scan is still O(n).
  */ 
 
 namespace brackets
@@ -100,6 +128,489 @@ namespace brackets
 		}
 	}
 
+	//same swaps as process_strings, but the next [ is searched by an index moving forward instead of being taken from open_brackets_indexes => O(1) extra memory
+	uint64_t balance_in_place(string& brackets_string)
+	{
+		uint64_t swaps = 0;
+		int64_t brackets_counter = 0;
+		size_t next_open = 0;
+		for(size_t idx = 0, size = brackets_string.size(); idx < size; ++idx)
+		{
+			if(brackets_string[idx] == '[')
+			{
+				++brackets_counter;
+			}
+			if(brackets_string[idx] == ']')
+			{
+				--brackets_counter;
+			}
+
+			if(brackets_counter < 0)
+			{
+				//the [ before idx are consumed by the iteration, the ones before next_open by previous swaps
+				next_open = max(next_open, idx + 1);
+				while(next_open < size && brackets_string[next_open] != '[')
+				{
+					++next_open;
+				}
+				//more ] than [: nothing left to swap with
+				if(next_open == size)
+				{
+					break;
+				}
+
+				swap(brackets_string[idx], brackets_string[next_open]);
+				++next_open;
+				brackets_counter = 1;
+				++swaps;
+			}
+		}
+		return swaps;
+	}
+
+	//number of swaps whose [ is found in the given block, knowing the balance before it, which is updated. No memory is allocated
+	uint64_t count_swaps(const char* data, size_t size, int64_t& balance)
+	{
+		uint64_t swaps = 0;
+		size_t idx = 0;
+
+	#ifdef __SSE2__
+		const __m128i open = _mm_set1_epi8('[');
+		const __m128i one = _mm_set1_epi8(1);
+		const __m128i zero = _mm_setzero_si128();
+		for(; idx + 16 <= size; idx += 16)
+		{
+			__m128i is_open = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + idx)), open);
+			unsigned open_mask = static_cast<unsigned>(_mm_movemask_epi8(is_open));
+			int opens = __builtin_popcount(open_mask);
+
+			//inside a block, the balance before a character is in [balance-15, balance+15]
+			if(balance >= 15)
+			{
+				balance += 2*opens - 16;
+				continue;
+			}
+			if(balance <= -16)
+			{
+				swaps += opens;
+				balance += 2*opens - 16;
+				continue;
+			}
+
+			//is_open is -1 for [ and 0 otherwise => is_open|1 is -1 or 1, so 0 - (is_open|1) is +1 for [ and -1 for anything else
+			__m128i steps = _mm_sub_epi8(zero, _mm_or_si128(is_open, one));
+			//inclusive prefix sums, in [-16, 16], so they fit in 8 bits
+			__m128i prefix = _mm_add_epi8(steps, _mm_slli_si128(steps, 1));
+			prefix = _mm_add_epi8(prefix, _mm_slli_si128(prefix, 2));
+			prefix = _mm_add_epi8(prefix, _mm_slli_si128(prefix, 4));
+			prefix = _mm_add_epi8(prefix, _mm_slli_si128(prefix, 8));
+			//balance before each character is balance + (prefix - step) < 0  <=>  prefix - step < -balance, where -balance is in [-14, 15]
+			__m128i negative = _mm_cmplt_epi8(_mm_sub_epi8(prefix, steps), _mm_set1_epi8(static_cast<char>(-balance)));
+			swaps += __builtin_popcount(static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(negative, is_open))));
+			balance += 2*opens - 16;
+		}
+	#endif
+
+		//the remaining characters, or all of them if SSE2 is not available
+		for(; idx < size; ++idx)
+		{
+			if(data[idx] == '[')
+			{
+				swaps += balance < 0 ? 1 : 0;
+				++balance;
+			}
+			else
+			{
+				--balance;
+			}
+		}
+
+		return swaps;
+	}
+
+	//number of swaps done by process_strings, without modifying the string
+	uint64_t count_swaps(const char* data, size_t size)
+	{
+		int64_t balance = 0;
+		return count_swaps(data, size, balance);
+	}
+
+	//net balance of a range and the minimum balance over its prefixes (the empty prefix included, so it is <= 0)
+	struct balance_summary
+	{
+		int64_t net = 0;
+		int64_t min_prefix = 0;
+	};
+
+	//summary of a range followed by another range
+	balance_summary combine(const balance_summary& first, const balance_summary& second)
+	{
+		return balance_summary{first.net + second.net, min(first.min_prefix, first.net + second.min_prefix)};
+	}
+
+	balance_summary summarize(const char* data, size_t size)
+	{
+		balance_summary summary;
+		for(size_t idx = 0; idx < size; ++idx)
+		{
+			summary.net += data[idx] == '[' ? 1 : -1;
+			summary.min_prefix = min(summary.min_prefix, summary.net);
+		}
+		return summary;
+	}
+
+	//rewrite a block found at 'position' in the whole string, given the balance before it, which is updated. Returns the number of swaps whose [ comes from this block
+	uint64_t rebalance_block(char* data, size_t size, uint64_t position, int64_t& balance)
+	{
+		uint64_t swaps = 0;
+		//bitwise & instead of && keeps the loop free of branches, which the random characters would mispredict
+		for(size_t idx = 0; idx < size; ++idx)
+		{
+			bool is_open = data[idx] == '[';
+			int64_t balance_after = balance + 2*static_cast<int64_t>(is_open) - 1;
+			swaps += is_open & (balance < 0);
+			bool even = ((position + idx) & 1) == 0;
+			data[idx] = ((is_open & (balance >= 0)) | (even & (balance_after < 0))) ? '[' : ']';
+			balance = balance_after;
+		}
+		return swaps;
+	}
+
+	//same result as process_strings for a single string: the string is rebalanced and the number of swaps is returned
+	uint64_t balance_parallel(string& brackets_string, unsigned workers = parallel_helpers::workers_count())
+	{
+		size_t size = brackets_string.size();
+		//a few chunks per worker, as the chunks which stay balanced are skipped and cost nothing in the 2nd pass
+		size_t chunks = min<size_t>(4*static_cast<size_t>(workers), max<size_t>(size, 1));
+		auto chunk_first{[&](size_t chunk){return size*chunk/chunks;}};
+
+		//Step 1: summarize the chunks in parallel
+		vector<balance_summary> summaries(chunks);
+		parallel_helpers::parallel_for_ranges(chunks, [&](size_t first, size_t last, unsigned)
+			{
+				for(size_t chunk = first; chunk < last; ++chunk)
+				{
+					summaries[chunk] = summarize(brackets_string.data() + chunk_first(chunk), chunk_first(chunk+1) - chunk_first(chunk));
+				}
+			}, workers);
+
+		//Step 2: exclusive prefix scan over the summaries => balance before every chunk
+		vector<int64_t> starts(chunks);
+		balance_summary prefix;
+		for(size_t chunk = 0; chunk < chunks; ++chunk)
+		{
+			starts[chunk] = prefix.net;
+			prefix = combine(prefix, summaries[chunk]);
+		}
+
+		//Step 3: rewrite each chunk independently. If the balance stays >= 0 over the whole chunk, nothing changes in it
+		vector<uint64_t> swaps(chunks, 0);
+		parallel_helpers::parallel_for_ranges(chunks, [&](size_t first, size_t last, unsigned)
+			{
+				for(size_t chunk = first; chunk < last; ++chunk)
+				{
+					if(starts[chunk] + summaries[chunk].min_prefix >= 0)
+					{
+						continue;
+					}
+					int64_t balance = starts[chunk];
+					swaps[chunk] = rebalance_block(&brackets_string[0] + chunk_first(chunk), chunk_first(chunk+1) - chunk_first(chunk), chunk_first(chunk), balance);
+				}
+			}, workers);
+
+		uint64_t total = 0;
+		for(uint64_t chunk_swaps : swaps)
+		{
+			total += chunk_swaps;
+		}
+		return total;
+	}
+
+	//random brackets with as many [ as ] (for an even size)
+	void generate_brackets(char* data, size_t size, benchmark_helpers::random_generator& generator)
+	{
+		int64_t balance = 0;
+		for(size_t idx = 0; idx < size; ++idx)
+		{
+			data[idx] = (generator.next()>>31) ? '[' : ']';
+			balance += data[idx] == '[' ? 1 : -1;
+		}
+		//flip the last characters till the counts are equal
+		for(size_t idx = size; balance != 0 && idx > 0; --idx)
+		{
+			if((balance > 0) == (data[idx-1] == '['))
+			{
+				data[idx-1] = balance > 0 ? ']' : '[';
+				balance += balance > 0 ? -2 : 2;
+			}
+		}
+	}
+
+	void generate_string(string& brackets_string, size_t size)
+	{
+		brackets_string.resize(size);
+		benchmark_helpers::random_generator generator;
+		generate_brackets(&brackets_string[0], size, generator);
+	}
+
+	//many strings packed one after another in a single buffer: the string idx is found in [offsets[idx], offsets[idx+1])
+	struct string_batch
+	{
+		vector<char> characters;
+		vector<uint64_t> offsets{0};
+
+		size_t size() const
+		{
+			return offsets.size() - 1;
+		}
+
+		void push_back(const string& brackets_string)
+		{
+			characters.insert(characters.end(), brackets_string.begin(), brackets_string.end());
+			offsets.push_back(characters.size());
+		}
+	};
+
+	void read_input_batch(string_batch& batch)
+	{
+		ifstream file;
+		file.open("brackets.txt", ios::in);
+
+		string line;
+		while(getline(file, line))
+		{
+			batch.push_back(line);
+		}
+
+		file.close();
+	}
+
+	//swaps[idx] gets the number of swaps of the string idx, so it must have batch.size() elements. If 'rebalance' is set, the strings are also rebalanced in the batch.
+	//Threads take contiguous ranges of strings and nothing is allocated per string
+	void process_batch(string_batch& batch, uint64_t* swaps, bool rebalance, unsigned workers = parallel_helpers::workers_count())
+	{
+		parallel_helpers::parallel_for_ranges(batch.size(), [&](size_t first, size_t last, unsigned)
+			{
+				for(size_t idx = first; idx < last; ++idx)
+				{
+					char* data = batch.characters.data() + batch.offsets[idx];
+					size_t size = batch.offsets[idx+1] - batch.offsets[idx];
+					int64_t balance = 0;
+					swaps[idx] = rebalance ? rebalance_block(data, size, 0, balance) : count_swaps(data, size, balance);
+				}
+			}, workers);
+	}
+
+	//many short random strings, with lengths in [2, 2*max_half_length]
+	void benchmark_batch(size_t strings, size_t max_half_length)
+	{
+		string_batch batch;
+		batch.offsets.resize(strings + 1);
+		benchmark_helpers::random_generator generator;
+		for(size_t idx = 0; idx < strings; ++idx)
+		{
+			batch.offsets[idx+1] = batch.offsets[idx] + 2*(1 + generator.next(max_half_length));
+		}
+		batch.characters.resize(batch.offsets.back());
+		//the counts must be equal in every string, not only overall
+		for(size_t idx = 0; idx < strings; ++idx)
+		{
+			generate_brackets(batch.characters.data() + batch.offsets[idx], batch.offsets[idx+1] - batch.offsets[idx], generator);
+		}
+
+		vector<uint64_t> swaps(strings);
+		cout<<"benchmark for a batch of "<<strings<<" strings, "<<batch.characters.size()<<" brackets, on "<<parallel_helpers::workers_count()<<" threads"<<endl;
+		//the last pass counts the swaps of the rebalanced strings, which must be 0
+		const pair<const char*, bool> passes[] = {{"count only", false}, {"rebalance", true}, {"count after rebalancing", false}};
+		for(const auto& pass : passes)
+		{
+			double elapsed = benchmark_helpers::seconds([&]{process_batch(batch, swaps.data(), pass.second);});
+			uint64_t total = 0;
+			for(uint64_t string_swaps : swaps)
+			{
+				total += string_swaps;
+			}
+			cout<<"    "<<pass.first<<": "<<total<<" swaps in "<<elapsed<<" s ("<<strings/elapsed/1e6<<" million strings/s)"<<endl;
+		}
+	}
+
+	//time the swaps counting on a large random string
+	void benchmark_count(size_t size)
+	{
+		string brackets_string;
+		generate_string(brackets_string, size);
+
+		uint64_t swaps = 0;
+		double elapsed = benchmark_helpers::seconds([&]{swaps = count_swaps(brackets_string.data(), brackets_string.size());});
+		cout<<"benchmark for a string of "<<size<<" brackets: "<<swaps<<" swaps counted in "<<elapsed<<" s ("<<size/elapsed/1e9<<" GB/s)"<<endl;
+	}
+
+	//time the rebalancing of a large random string, split between threads
+	void benchmark_parallel(size_t size)
+	{
+		string brackets_string;
+		generate_string(brackets_string, size);
+		uint64_t counted = count_swaps(brackets_string.data(), brackets_string.size());
+
+		uint64_t swaps = 0;
+		double elapsed = benchmark_helpers::seconds([&]{swaps = balance_parallel(brackets_string);});
+		cout<<"benchmark for a string of "<<size<<" brackets: rebalanced on "<<parallel_helpers::workers_count()<<" threads, "<<swaps<<" swaps in "<<elapsed<<" s, same as counted: "<<(swaps == counted ? "yes" : "no")
+			<<", balanced afterwards: "<<(count_swaps(brackets_string.data(), brackets_string.size()) == 0 ? "yes" : "no")<<endl;
+	}
+
+	//time the rebalancing of a large random string in a single pass, on one thread
+	void benchmark_in_place(size_t size)
+	{
+		string brackets_string;
+		generate_string(brackets_string, size);
+		uint64_t counted = count_swaps(brackets_string.data(), brackets_string.size());
+
+		uint64_t swaps = 0;
+		double elapsed = benchmark_helpers::seconds([&]{swaps = balance_in_place(brackets_string);});
+		cout<<"benchmark for a string of "<<size<<" brackets: rebalanced in place, "<<swaps<<" swaps in "<<elapsed<<" s, same as counted: "<<(swaps == counted ? "yes" : "no")
+			<<", balanced afterwards: "<<(count_swaps(brackets_string.data(), brackets_string.size()) == 0 ? "yes" : "no")<<endl;
+	}
+
+	struct stream_result
+	{
+		uint64_t brackets = 0;
+		uint64_t swaps = 0;
+		double seconds = 0;
+	};
+
+	//read a single line of brackets from 'input', buffer_size characters at a time. If 'output' is given, the rebalanced line is written to it. Memory usage is one buffer, whatever the input size
+	stream_result stream_balance(istream& input, ostream* output, size_t buffer_size = size_t{1}<<20)
+	{
+		stream_result result;
+		vector<char> buffer(buffer_size);
+		int64_t balance = 0;
+		bool end_of_line = false;
+		result.seconds = benchmark_helpers::seconds([&]
+			{
+				while(!end_of_line && input)
+				{
+					input.read(buffer.data(), buffer.size());
+					size_t size = static_cast<size_t>(input.gcount());
+					if(size == 0)
+					{
+						break;
+					}
+
+					//the line ends at the first new line character
+					char* line_end = static_cast<char*>(memchr(buffer.data(), '\n', size));
+					if(line_end != nullptr)
+					{
+						size = static_cast<size_t>(line_end - buffer.data());
+						end_of_line = true;
+					}
+
+					if(output != nullptr)
+					{
+						result.swaps += rebalance_block(buffer.data(), size, result.brackets, balance);
+						output->write(buffer.data(), size);
+					}
+					else
+					{
+						result.swaps += count_swaps(buffer.data(), size, balance);
+					}
+					result.brackets += size;
+				}
+			});
+		return result;
+	}
+
+	void print_stream_result(const char* name, const stream_result& result)
+	{
+		cout<<"    "<<name<<": "<<result.brackets<<" brackets, "<<result.swaps<<" swaps in "<<result.seconds<<" s ("<<result.brackets/result.seconds/1e9<<" GB/s)"<<endl;
+	}
+
+	//read only stream of 'size' random brackets followed by a new line. The brackets are generated one buffer at a time, when they are read, so a dump of any size is streamed without
+	//being stored in memory or on disk
+	class generated_brackets_buffer : public streambuf
+	{
+	public:
+		explicit generated_brackets_buffer(uint64_t size, size_t buffer_size = size_t{1}<<20)
+			: remaining(size), buffer(buffer_size + 1)
+		{
+		}
+
+	protected:
+		int_type underflow() override
+		{
+			if(finished)
+			{
+				return traits_type::eof();
+			}
+
+			//an even buffer size keeps as many [ as ] in every buffer, so also in the whole dump
+			size_t size = static_cast<size_t>(min<uint64_t>(remaining, (buffer.size() - 1)/2*2));
+			generate_brackets(buffer.data(), size, generator);
+			remaining -= size;
+			if(remaining == 0)
+			{
+				buffer[size++] = '\n';
+				finished = true;
+			}
+			setg(buffer.data(), buffer.data(), buffer.data() + size);
+			return traits_type::to_int_type(buffer[0]);
+		}
+
+	private:
+		uint64_t remaining;
+		vector<char> buffer;
+		benchmark_helpers::random_generator generator;
+		bool finished = false;
+	};
+
+	//write only stream that keeps nothing but the swaps needed by the brackets written to it, so a rebalanced dump is checked without being stored
+	class swaps_counting_buffer : public streambuf
+	{
+	public:
+		uint64_t swaps() const
+		{
+			return swaps_count;
+		}
+
+	protected:
+		streamsize xsputn(const char* data, streamsize size) override
+		{
+			swaps_count += count_swaps(data, static_cast<size_t>(size), balance);
+			return size;
+		}
+
+		int_type overflow(int_type character) override
+		{
+			if(!traits_type::eq_int_type(character, traits_type::eof()))
+			{
+				char value = traits_type::to_char_type(character);
+				xsputn(&value, 1);
+			}
+			return traits_type::not_eof(character);
+		}
+
+	private:
+		uint64_t swaps_count = 0;
+		int64_t balance = 0;
+	};
+
+	//stream a generated dump twice: once counting only, once rebalancing it into a stream which checks that no swaps are left. The times include the generation of the brackets
+	void benchmark_stream(uint64_t size)
+	{
+		cout<<"streaming a generated dump of "<<size<<" brackets"<<endl;
+		{
+			generated_brackets_buffer dump(size);
+			istream input(&dump);
+			print_stream_result("count only", stream_balance(input, nullptr));
+		}
+
+		generated_brackets_buffer dump(size);
+		istream input(&dump);
+		swaps_counting_buffer balanced;
+		ostream output(&balanced);
+		print_stream_result("rebalanced", stream_balance(input, &output));
+		cout<<"    swaps left in the rebalanced stream: "<<balanced.swaps()<<endl;
+	}
+
 	void print_ordered_strings(vector<string>& brackets_array, vector<unsigned>& swaps)
 	{
 		cout<<"ordered brackets string              number of needed swaps"<<endl;
@@ -120,4 +631,62 @@ void brackets_swapping()
 	brackets::process_strings(brackets_array, swaps);
 	
 	brackets::print_ordered_strings(brackets_array, swaps);
+
+	//the counting kernel gives the same numbers without touching the strings
+	std::vector<std::string> input_array;
+	brackets::read_input_strings(input_array);
+	std::cout<<std::endl<<"swaps counted from the balance only:";
+	for(const std::string& brackets_string : input_array)
+	{
+		std::cout<<" "<<brackets::count_swaps(brackets_string.data(), brackets_string.size());
+	}
+	std::cout<<std::endl;
+
+	//the parallel rebalancing must give the same strings as process_strings
+	std::cout<<"parallel rebalancing:";
+	for(size_t idx = 0, size = input_array.size(); idx < size; ++idx)
+	{
+		std::string brackets_string = input_array[idx];
+		uint64_t parallel_swaps = brackets::balance_parallel(brackets_string);
+		std::cout<<" "<<brackets_string<<" "<<parallel_swaps<<(brackets_string == brackets_array[idx] && parallel_swaps == swaps[idx] ? " (same)" : " (different)");
+	}
+	std::cout<<std::endl;
+
+	//and so must the in place rebalancing
+	std::cout<<"in place rebalancing:";
+	for(size_t idx = 0, size = input_array.size(); idx < size; ++idx)
+	{
+		std::string brackets_string = input_array[idx];
+		uint64_t in_place_swaps = brackets::balance_in_place(brackets_string);
+		std::cout<<" "<<brackets_string<<" "<<in_place_swaps<<(brackets_string == brackets_array[idx] && in_place_swaps == swaps[idx] ? " (same)" : " (different)");
+	}
+	std::cout<<std::endl;
+
+	//all the strings of the file at once, in a single buffer
+	brackets::string_batch batch;
+	brackets::read_input_batch(batch);
+	std::vector<uint64_t> batch_swaps(batch.size());
+	brackets::process_batch(batch, batch_swaps.data(), true);
+	std::cout<<"batch:";
+	for(size_t idx = 0, size = batch.size(); idx < size; ++idx)
+	{
+		std::cout<<" "<<std::string(batch.characters.data() + batch.offsets[idx], batch.characters.data() + batch.offsets[idx+1])<<" "<<batch_swaps[idx];
+	}
+	std::cout<<std::endl;
+
+	//a line longer than the stream buffer, to check the results carried from a buffer to the next one
+	std::istringstream line(input_array.empty() ? std::string() : input_array[0]);
+	std::ostringstream balanced_line;
+	brackets::stream_result result = brackets::stream_balance(line, &balanced_line, 3);
+	std::cout<<"streamed with a 3 characters buffer: "<<balanced_line.str()<<" "<<result.swaps<<std::endl;
+}
+
+//the same algorithms on inputs large enough to be timed. They take seconds and allocate up to 2GB, so this driver is not run by default
+void brackets_swapping_benchmark()
+{
+	brackets::benchmark_count(size_t{1}<<30);
+	brackets::benchmark_parallel(size_t{1}<<30);
+	brackets::benchmark_in_place(size_t{1}<<30);
+	brackets::benchmark_batch(10000000, 16);
+	brackets::benchmark_stream(uint64_t{1}<<30);
 }
@@ -1,5 +1,19 @@
 #include "standard_greedy_algorithms.hpp"
 #include <cstdio>
+#include "../parallel_helpers.hpp"
+#include "../benchmark_helpers.hpp"
+#include <chrono>
+#include <cstdint>
+#include <numeric>
+#include <limits>
+#include <atomic>
+#include <mutex>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <filesystem>
 
 /*
  * Given a fraction (numerator/denominator) it should be wriiten as a sum of unique unit fractions (1/x +1/y +1/z etc)
@@ -13,6 +27,35 @@
  * 				Following this approach, if instead of considering c, is taken into account the upper bound integer of c (let's name it L) then it would represent the integer superior limit of reversed input fraction b/a. 
  * 				Nonetheless, if reversed (1/L), then it would represent the inferior limit of input fraction a/b. Thus, it is obtained each unique unit fraction.
  * 				Then, it is proceeded similarily for the remainder (a/b -1/L) => recursion
+ *
+ * 			 process_fraction keeps its result in a static string, so it cannot be called from several threads, and it formats strings at every step. The same steps can be done iteratively,
+ * 			 writing only the denominators in a buffer given by the caller (expand_fraction):
+ * 				- the integer part is returned separately, the rest of the algorithm works on the subunitary remainder
+ * 				- at each step, the remainder a/b is reduced by gcd(a, b), which keeps the values as small as possible, then 1/ceiling is written and a/b becomes (a*ceiling - b)/(b*ceiling)
+ * 				- the values are 64 bits wide and every product is checked for overflow, so an expansion that does not fit is reported instead of returning garbage
+ * 			 As no state is shared, a batch of fractions can be split in ranges, each one expanded by its own thread in its own part of a preallocated denominators pool.
+ *
+ * 			 The Greedy expansion is not the shortest one, nor the one with the smallest denominators (4/17 = 1/5 + 1/29 + 1/1233 + 1/3039345, but also 1/6 + 1/17 + 1/102). The optimal expansion is found
+ * 			 by search (optimize_fraction), bounded by a maximum number of terms, a maximum denominator and a time limit:
+ * 				- iterative deepening: try all the expansions with 1 term, then 2 terms and so on. The first depth with a solution gives the fewest terms
+ * 				- the denominators are searched in ascending order, so they are unique. For a remainder a/b with k terms left, the next denominator d has to satisfy 1/d <= a/b (d >= ceil(b/a)) and
+ * 				  k/d >= a/b (d <= k*b/a), as the next k-1 unit fractions are smaller than 1/d. With 1 term left, a/b must be a unit fraction itself
+ * 				- the largest denominator is always the last one. Once a solution is found, the next ones must have a smaller last denominator, which bounds all the denominators from then on
+ * 				- the candidates for the first denominator are split between threads, which share the bound of the best solution found so far. The threads are spawned once and
+ * 				  wait for each other at the end of each depth (barrier), as the next depth starts only when the current one is fully searched
+ * 				- when asked for the fewest terms, the search stops at the first depth with a solution (picking, at that depth, the one with the smallest maximum denominator). When asked for the
+ * 				  smallest maximum denominator, all the depths up to the maximum number of terms are searched
+ * 			 If the time limit is reached before any solution is found, the Greedy expansion is returned, whatever its number of terms. If it does not fit in 64 bits, it is marked as truncated.
+ *
+ * 			 When many fractions with small denominators are converted, all the expansions can be precomputed once (fraction_table):
+ * 				- only the reduced fractions get a slot, as a lookup reduces its input first. In row b, the slot of a/b is the rank of a among the numerators coprime with b, found by
+ * 				  inclusion-exclusion over the square free divisors of b (at most 31 of them besides 1 for b <= 10^4), which the table keeps for each row
+ * 				- each row has a 64 bits base in the pool and 32 bits offsets inside the row, so offsets[slot] and offsets[slot+1] delimit the slot's expansion in the row's part of the pool
+ * 				- most denominators fit in 32 bits, so the pool is made of 32 bits words. A wider denominator is written as an escape word followed by its low and high halves
+ * 				- the table is built in 2 passes, with the rows (denominators) split between threads: first each expansion only counts its words, summed in the row's offsets, then the rows'
+ * 				  bases are computed as prefix sums and each expansion is written directly in its place in the pool
+ * 				- the table has no pointers inside, so it is saved as header + rows + divisors + offsets + pool and can be mapped back in memory (mmap) without any parsing
+ * 			 An expansion which does not fit in 64 bits gets an empty slot, so it is computed again (and reported as such) on lookup, as any fraction beyond the bound.
  */
 
 using namespace std;
@@ -92,6 +135,756 @@ namespace egyptian_fraction_processing
 		
 		return process_fraction(remaining_fraction);
 	}
+
+	enum expansion_status
+	{
+		expansion_ok,
+		expansion_invalid,			//denominator is 0
+		expansion_overflow,			//a denominator does not fit in 64 bits
+		expansion_buffer_full		//more denominators than the buffer can hold
+	};
+
+	struct expansion
+	{
+		uint64_t integer_part;
+		size_t terms;				//number of denominators written in the buffer
+		expansion_status status;
+	};
+
+	//numerator/denominator = integer_part + 1/denominators[0] + ... + 1/denominators[terms-1]. Reentrant: it only touches its arguments
+	expansion expand_fraction(uint64_t numerator, uint64_t denominator, uint64_t* denominators, size_t capacity)
+	{
+		expansion result{0, 0, expansion_ok};
+		if(denominator == 0)
+		{
+			result.status = expansion_invalid;
+			return result;
+		}
+
+		//the integer part is written separately, then it is proceeded with the subunitary remainder
+		result.integer_part = numerator/denominator;
+		numerator %= denominator;
+
+		while(numerator != 0)
+		{
+			uint64_t divisor = gcd(numerator, denominator);
+			numerator /= divisor;
+			denominator /= divisor;
+
+			if(result.terms == capacity)
+			{
+				result.status = expansion_buffer_full;
+				return result;
+			}
+
+			//the reduced remainder is already a unit fraction: this is the last term
+			if(numerator == 1)
+			{
+				denominators[result.terms++] = denominator;
+				return result;
+			}
+
+			//Step 1 and 2: 1/ceiling is the greatest unit fraction not greater than the remainder
+			uint64_t ceiling = denominator/numerator + 1;
+			denominators[result.terms++] = ceiling;
+
+			//Step 3: remainder - 1/ceiling = (numerator*ceiling - denominator)/(denominator*ceiling)
+			uint64_t next_numerator, next_denominator;
+			if(__builtin_mul_overflow(numerator, ceiling, &next_numerator) || __builtin_mul_overflow(denominator, ceiling, &next_denominator))
+			{
+				result.status = expansion_overflow;
+				return result;
+			}
+			numerator = next_numerator - denominator;
+			denominator = next_denominator;
+		}
+
+		return result;
+	}
+
+	//expands fractions[idx] in pool[idx*max_terms, (idx+1)*max_terms), on as many threads as available. Nothing is allocated once the pool and results are sized
+	void expand_batch(const vector<pair<uint64_t, uint64_t>>& fractions, size_t max_terms, vector<uint64_t>& pool, vector<expansion>& results)
+	{
+		pool.resize(fractions.size()*max_terms);
+		results.resize(fractions.size());
+
+		parallel_helpers::parallel_for_ranges(fractions.size(), [&](size_t first, size_t last, unsigned)
+			{
+				for(size_t idx = first; idx < last; ++idx)
+				{
+					results[idx] = expand_fraction(fractions[idx].first, fractions[idx].second, pool.data() + idx*max_terms, max_terms);
+				}
+			});
+	}
+
+	void print_expansion(uint64_t numerator, uint64_t denominator, const expansion& result, const uint64_t* denominators)
+	{
+		cout<<numerator<<"/"<<denominator<<" = ";
+		switch(result.status)
+		{
+			case expansion_invalid:
+				cout<<"invalid fraction"<<endl;
+				return;
+			case expansion_overflow:
+				cout<<"(denominators overflow 64 bits after "<<result.terms<<" terms) ";
+				break;
+			case expansion_buffer_full:
+				cout<<"(more than "<<result.terms<<" terms) ";
+				break;
+			default:
+				break;
+		}
+
+		bool first_term = true;
+		if(result.integer_part != 0 || result.terms == 0)
+		{
+			cout<<result.integer_part;
+			first_term = false;
+		}
+		for(size_t idx = 0; idx < result.terms; ++idx)
+		{
+			cout<<(first_term ? "" : " + ")<<"1/"<<denominators[idx];
+			first_term = false;
+		}
+		cout<<endl;
+	}
+
+	//random fractions a/b with 1 <= a < b <= max_denominator, expanded in parallel
+	void benchmark(size_t size, uint64_t max_denominator, size_t max_terms)
+	{
+		vector<pair<uint64_t, uint64_t>> fractions(size);
+		benchmark_helpers::random_generator generator;
+		for(auto& fraction : fractions)
+		{
+			fraction.second = 2 + generator.next(max_denominator-1);
+			fraction.first = 1 + generator.next(fraction.second-1);
+		}
+
+		vector<uint64_t> pool;
+		vector<expansion> results;
+		double elapsed = benchmark_helpers::seconds([&]{expand_batch(fractions, max_terms, pool, results);});
+
+		size_t overflows = 0, terms = 0;
+		for(const expansion& result : results)
+		{
+			overflows += (result.status != expansion_ok);
+			terms += result.terms;
+		}
+		cout<<"batch of "<<size<<" fractions with denominators up to "<<max_denominator<<" on "<<parallel_helpers::workers_count()<<" threads: "<<terms<<" terms, "<<overflows
+			<<" expansions not fitting 64 bits or "<<max_terms<<" terms, in "<<elapsed<<" s"<<endl;
+	}
+
+	enum optimization_goal
+	{
+		fewest_terms,
+		smallest_max_denominator
+	};
+
+	struct optimization_budget
+	{
+		size_t max_terms;
+		uint64_t max_denominator;
+		chrono::milliseconds time_limit;
+	};
+
+	struct optimized_expansion
+	{
+		uint64_t integer_part = 0;
+		vector<uint64_t> denominators;
+		bool complete = false;			//the whole search space within the budget was searched, so the result is optimal
+		bool from_greedy = false;		//the time ran out before any solution was found, so this is the Greedy expansion
+		bool truncated = false;			//the Greedy expansion does not fit in 64 bits, so only its first denominators are given
+	};
+
+	//state shared by the threads searching the same fraction
+	struct search_context
+	{
+		chrono::steady_clock::time_point deadline;
+		atomic<bool> timed_out{false};
+		//every denominator of a new solution must be <= bound. It starts as the budget's max denominator and becomes best max denominator - 1 once a solution is found
+		atomic<uint64_t> bound;
+		mutex best_mutex;
+		vector<uint64_t> best;
+	};
+
+	//numerator/denominator - 1/next = (numerator*next - denominator)/(denominator*next), reduced by gcd. The products are computed on 128 bits. Returns false if the result is 0 (the
+	//remainder was exactly 1/next) or if its denominator does not fit in 64 bits, as then it needs denominators beyond any 64 bits budget
+	bool subtract_unit_fraction(uint64_t numerator, uint64_t denominator, uint64_t next, uint64_t& next_numerator, uint64_t& next_denominator)
+	{
+		unsigned __int128 result_numerator = static_cast<unsigned __int128>(numerator)*next - denominator;
+		unsigned __int128 result_denominator = static_cast<unsigned __int128>(denominator)*next;
+		if(result_numerator == 0)
+		{
+			return false;
+		}
+
+		unsigned __int128 lhs = result_numerator, rhs = result_denominator;
+		while(rhs != 0)
+		{
+			unsigned __int128 rest = lhs%rhs;
+			lhs = rhs;
+			rhs = rest;
+		}
+		result_numerator /= lhs;
+		result_denominator /= lhs;
+		if(result_denominator > numeric_limits<uint64_t>::max())
+		{
+			return false;
+		}
+
+		next_numerator = static_cast<uint64_t>(result_numerator);
+		next_denominator = static_cast<uint64_t>(result_denominator);
+		return true;
+	}
+
+	//depth first search for the expansions of numerator/denominator in exactly 'terms' unit fractions, with denominators >= min_denominator
+	void search_expansions(uint64_t numerator, uint64_t denominator, size_t terms, uint64_t min_denominator, vector<uint64_t>& path, search_context& context, size_t& nodes)
+	{
+		//checking the clock is not free, so do it once every 1024 nodes
+		if((++nodes & 1023) == 0 && chrono::steady_clock::now() > context.deadline)
+		{
+			context.timed_out = true;
+		}
+		if(context.timed_out)
+		{
+			return;
+		}
+
+		uint64_t bound = context.bound.load();
+		if(terms == 1)
+		{
+			//the remainder is reduced, so it is a unit fraction only if its numerator is 1
+			if(numerator == 1 && denominator >= min_denominator && denominator <= bound)
+			{
+				lock_guard<mutex> lock(context.best_mutex);
+				if(denominator <= context.bound.load())
+				{
+					context.best = path;
+					context.best.push_back(denominator);
+					context.bound = denominator - 1;
+				}
+			}
+			return;
+		}
+
+		//1/d <= numerator/denominator and terms/d >= numerator/denominator
+		unsigned __int128 upper = static_cast<unsigned __int128>(denominator)*terms/numerator;
+		uint64_t first = max(min_denominator, denominator/numerator + (denominator%numerator != 0));
+		uint64_t last = static_cast<uint64_t>(min<unsigned __int128>(upper, bound));
+		for(uint64_t next = first; next <= last && next <= context.bound.load(); ++next)
+		{
+			//a remainder of exactly 1/next is already covered by a smaller depth
+			uint64_t next_numerator, next_denominator;
+			if(!subtract_unit_fraction(numerator, denominator, next, next_numerator, next_denominator))
+			{
+				continue;
+			}
+
+			path.push_back(next);
+			search_expansions(next_numerator, next_denominator, terms-1, next+1, path, context, nodes);
+			path.pop_back();
+			if(context.timed_out)
+			{
+				return;
+			}
+		}
+	}
+
+	optimized_expansion optimize_fraction(uint64_t numerator, uint64_t denominator, optimization_goal goal, const optimization_budget& budget)
+	{
+		optimized_expansion result;
+		if(denominator == 0)
+		{
+			return result;
+		}
+
+		result.integer_part = numerator/denominator;
+		numerator %= denominator;
+		if(numerator == 0)
+		{
+			result.complete = true;
+			return result;
+		}
+		uint64_t divisor = gcd(numerator, denominator);
+		numerator /= divisor;
+		denominator /= divisor;
+
+		search_context context;
+		context.deadline = chrono::steady_clock::now() + budget.time_limit;
+		context.bound = budget.max_denominator;
+
+		//depth 1 needs no threads: the remainder is either a unit fraction or not
+		if(budget.max_terms >= 1)
+		{
+			vector<uint64_t> path;
+			size_t nodes = 0;
+			search_expansions(numerator, denominator, 1, 1, path, context, nodes);
+		}
+
+		//the candidates for the first denominator at depth 'terms', as in search_expansions. Each thread takes the next untried candidate, as the subtrees of the small
+		//candidates are much larger than the ones of the large candidates. Returns false when the search is over
+		size_t terms = 1;
+		uint64_t last = 0;
+		atomic<uint64_t> next_candidate{0};
+		auto next_depth{[&]
+					{
+						while(++terms <= budget.max_terms && !context.timed_out && !(goal == fewest_terms && !context.best.empty()))
+						{
+							uint64_t first = denominator/numerator + (denominator%numerator != 0);
+							last = static_cast<uint64_t>(min<unsigned __int128>(static_cast<unsigned __int128>(denominator)*terms/numerator, context.bound.load()));
+							next_candidate = first;
+							if(first <= last)
+							{
+								return true;
+							}
+						}
+						return false;
+					}
+				};
+
+		//the threads are spawned once and go through all the depths together: the last one to finish a depth prepares the next one
+		bool searching = next_depth();
+		if(searching)
+		{
+			unsigned workers = parallel_helpers::workers_count();
+			parallel_helpers::barrier depth_done(workers);
+			parallel_helpers::parallel_for_ranges(workers, [&](size_t, size_t, unsigned)
+				{
+					vector<uint64_t> path;
+					size_t nodes = 0;
+					while(searching)
+					{
+						for(uint64_t candidate = next_candidate++; candidate <= last && candidate <= context.bound.load() && !context.timed_out; candidate = next_candidate++)
+						{
+							uint64_t next_numerator, next_denominator;
+							if(!subtract_unit_fraction(numerator, denominator, candidate, next_numerator, next_denominator))
+							{
+								continue;
+							}
+							path.assign(1, candidate);
+							search_expansions(next_numerator, next_denominator, terms-1, candidate+1, path, context, nodes);
+						}
+						depth_done.wait([&]{searching = next_depth();});
+					}
+				}, workers);
+		}
+
+		result.complete = !context.timed_out;
+		if(!context.best.empty())
+		{
+			result.denominators = context.best;
+			return result;
+		}
+
+		//nothing found within the budget: fall back to Greedy. Its denominators at least square at each step, so far fewer than 64 of them fit in 64 bits and the buffer
+		//never gets full, whatever the budget's max terms
+		if(context.timed_out)
+		{
+			vector<uint64_t> greedy(64);
+			expansion fallback = expand_fraction(numerator, denominator, greedy.data(), greedy.size());
+			greedy.resize(fallback.terms);
+			result.denominators = greedy;
+			result.from_greedy = true;
+			result.truncated = fallback.status != expansion_ok;
+		}
+		return result;
+	}
+
+	void print_optimized(uint64_t numerator, uint64_t denominator, const optimized_expansion& result)
+	{
+		cout<<numerator<<"/"<<denominator<<" = ";
+		if(denominator == 0)
+		{
+			cout<<"invalid fraction"<<endl;
+			return;
+		}
+		bool first_term = true;
+		if(result.integer_part != 0 || result.denominators.empty())
+		{
+			cout<<result.integer_part;
+			first_term = false;
+		}
+		for(uint64_t term : result.denominators)
+		{
+			cout<<(first_term ? "" : " + ")<<"1/"<<term;
+			first_term = false;
+		}
+		if(result.truncated)
+		{
+			cout<<" + ... (time out, Greedy expansion, the next denominators overflow 64 bits)";
+		}
+		else if(result.from_greedy)
+		{
+			cout<<" (time out, Greedy expansion)";
+		}
+		else if(!result.complete)
+		{
+			cout<<" (time out, best found)";
+		}
+		else if(result.denominators.empty() && numerator%denominator != 0)
+		{
+			cout<<" (no expansion within budget)";
+		}
+		cout<<endl;
+	}
+
+	//precomputed expansions of all the reduced fractions a/b with 1 <= a < b <= bound
+	class fraction_table
+	{
+	public:
+		fraction_table() = default;
+		fraction_table(const fraction_table&) = delete;
+		fraction_table& operator=(const fraction_table&) = delete;
+
+		~fraction_table()
+		{
+			unmap();
+		}
+
+		void build(uint32_t bound, size_t max_terms)
+		{
+			unmap();
+			//the signed divisors are 32 bits wide
+			header.bound = min<uint32_t>(max<uint32_t>(bound, 1), numeric_limits<int32_t>::max());
+			owned_rows.assign(header.bound + 2, table_row());
+			owned_divisors.clear();
+			rows = owned_rows.data();
+
+			//smallest prime factors sieve, from which each row gets its square free divisors. Each new prime p adds -p and the previous divisors times -p
+			vector<uint32_t> smallest_prime(header.bound + 1, 0);
+			for(uint32_t row = 2; row <= header.bound; ++row)
+			{
+				if(smallest_prime[row] == 0)
+				{
+					for(uint64_t multiple = row; multiple <= header.bound; multiple += row)
+					{
+						if(smallest_prime[multiple] == 0)
+						{
+							smallest_prime[multiple] = row;
+						}
+					}
+				}
+			}
+			for(uint32_t row = 0; row <= header.bound + 1; ++row)
+			{
+				owned_rows[row].first_divisor = static_cast<uint32_t>(owned_divisors.size());
+				for(uint32_t value = row; row <= header.bound && value > 1;)
+				{
+					uint32_t prime = smallest_prime[value];
+					while(value%prime == 0)
+					{
+						value /= prime;
+					}
+					for(size_t divisor = owned_rows[row].first_divisor, previous = owned_divisors.size(); divisor < previous; ++divisor)
+					{
+						owned_divisors.push_back(-owned_divisors[divisor]*static_cast<int32_t>(prime));
+					}
+					owned_divisors.push_back(-static_cast<int32_t>(prime));
+				}
+			}
+			header.divisors_count = owned_divisors.size();
+			divisors = owned_divisors.data();
+
+			//the count of reduced numerators of each row (Euler's totient) gives where the row's offsets start
+			uint64_t first_offset = 0;
+			for(uint32_t row = 0; row <= header.bound + 1; ++row)
+			{
+				owned_rows[row].first_offset = first_offset;
+				if(row >= 2 && row <= header.bound)
+				{
+					first_offset += coprime_rank(row + 1, row) + 1;
+				}
+			}
+			header.offsets_count = first_offset;
+			owned_offsets.assign(header.offsets_count, 0);
+
+			//Pass 1: count the pool words of each reduced fraction. A row is handled by a single thread, so its in-row offsets are summed there.
+			//Rows are taken one by one from a shared counter, as the last rows are the longest
+			atomic<uint32_t> next_row{2};
+			parallel_helpers::parallel_for_ranges(parallel_helpers::workers_count(), [&](size_t, size_t, unsigned)
+				{
+					vector<uint64_t> buffer(max_terms);
+					for(uint32_t row = next_row++; row <= header.bound; row = next_row++)
+					{
+						uint32_t* offsets_of_row = owned_offsets.data() + owned_rows[row].first_offset;
+						uint32_t rank = 0;
+						for(uint32_t numerator = 1; numerator < row; ++numerator)
+						{
+							if(gcd(numerator, row) == 1)
+							{
+								expansion result = expand_fraction(numerator, row, buffer.data(), buffer.size());
+								offsets_of_row[rank+1] = offsets_of_row[rank] + (result.status == expansion_ok ? encoded_words(buffer.data(), result.terms) : 0);
+								++rank;
+							}
+						}
+					}
+				});
+
+			//the rows' word counts become the rows' pool bases
+			uint64_t pool_base = 0;
+			for(uint32_t row = 0; row <= header.bound + 1; ++row)
+			{
+				owned_rows[row].pool_base = pool_base;
+				if(row >= 2 && row <= header.bound)
+				{
+					pool_base += owned_offsets[owned_rows[row+1].first_offset - 1];
+				}
+			}
+			header.pool_words = pool_base;
+			owned_pool.assign(header.pool_words, 0);
+
+			//Pass 2: expand again and write the encoded denominators in their place
+			next_row = 2;
+			parallel_helpers::parallel_for_ranges(parallel_helpers::workers_count(), [&](size_t, size_t, unsigned)
+				{
+					vector<uint64_t> buffer(max_terms);
+					for(uint32_t row = next_row++; row <= header.bound; row = next_row++)
+					{
+						const uint32_t* offsets_of_row = owned_offsets.data() + owned_rows[row].first_offset;
+						uint32_t* pool_of_row = owned_pool.data() + owned_rows[row].pool_base;
+						uint32_t rank = 0;
+						for(uint32_t numerator = 1; numerator < row; ++numerator)
+						{
+							if(gcd(numerator, row) == 1)
+							{
+								if(offsets_of_row[rank+1] != offsets_of_row[rank])
+								{
+									expansion result = expand_fraction(numerator, row, buffer.data(), buffer.size());
+									encode(buffer.data(), result.terms, pool_of_row + offsets_of_row[rank]);
+								}
+								++rank;
+							}
+						}
+					}
+				});
+
+			offsets = owned_offsets.data();
+			pool = owned_pool.data();
+		}
+
+		//header, rows, divisors, offsets and pool, one after another
+		bool save(const char* path) const
+		{
+			ofstream file(path, ios::binary);
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			file.write(reinterpret_cast<const char*>(rows), (header.bound + 2)*sizeof(table_row));
+			file.write(reinterpret_cast<const char*>(divisors), header.divisors_count*sizeof(int32_t));
+			file.write(reinterpret_cast<const char*>(offsets), header.offsets_count*sizeof(uint32_t));
+			file.write(reinterpret_cast<const char*>(pool), header.pool_words*sizeof(uint32_t));
+			return static_cast<bool>(file);
+		}
+
+		//map a saved table in memory, read only. The pages are loaded by the OS when they are first touched
+		bool map(const char* path)
+		{
+			unmap();
+			owned_rows.clear();
+			owned_divisors.clear();
+			owned_offsets.clear();
+			owned_pool.clear();
+
+			int descriptor = open(path, O_RDONLY);
+			if(descriptor < 0)
+			{
+				return false;
+			}
+			struct stat info;
+			bool valid = fstat(descriptor, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(header);
+			void* address = valid ? mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0) : MAP_FAILED;
+			close(descriptor);
+			if(address == MAP_FAILED)
+			{
+				return false;
+			}
+
+			memcpy(&header, address, sizeof(header));
+			if(header.magic != table_magic || static_cast<size_t>(info.st_size) != memory_bytes())
+			{
+				munmap(address, info.st_size);
+				header = table_header();
+				return false;
+			}
+
+			mapped = address;
+			mapped_size = info.st_size;
+			const char* position = static_cast<const char*>(address) + sizeof(header);
+			rows = reinterpret_cast<const table_row*>(position);
+			divisors = reinterpret_cast<const int32_t*>(position + divisors_position());
+			offsets = reinterpret_cast<const uint32_t*>(position + offsets_position());
+			pool = reinterpret_cast<const uint32_t*>(position + pool_position());
+			return true;
+		}
+
+		uint32_t bound() const
+		{
+			return static_cast<uint32_t>(header.bound);
+		}
+
+		size_t memory_bytes() const
+		{
+			return sizeof(header) + pool_position() + header.pool_words*sizeof(uint32_t);
+		}
+
+		//O(number of square free divisors of the reduced denominator) to find the slot. On a hit, the denominators are decoded in the caller's buffer
+		bool lookup(uint64_t numerator, uint64_t denominator, uint64_t& integer_part, uint64_t* denominators, size_t capacity, size_t& terms) const
+		{
+			if(denominator == 0 || offsets == nullptr)
+			{
+				return false;
+			}
+			integer_part = numerator/denominator;
+			numerator %= denominator;
+			terms = 0;
+			if(numerator == 0)
+			{
+				return true;
+			}
+			uint64_t divisor = gcd(numerator, denominator);
+			numerator /= divisor;
+			denominator /= divisor;
+			if(denominator > header.bound)
+			{
+				return false;
+			}
+
+			const uint32_t* offsets_of_row = offsets + rows[denominator].first_offset;
+			uint64_t rank = coprime_rank(static_cast<uint32_t>(numerator), static_cast<uint32_t>(denominator));
+			const uint32_t* word = pool + rows[denominator].pool_base + offsets_of_row[rank];
+			const uint32_t* end = pool + rows[denominator].pool_base + offsets_of_row[rank+1];
+			while(word != end)
+			{
+				if(terms == capacity)
+				{
+					return false;
+				}
+				if(*word != wide_escape)
+				{
+					denominators[terms++] = *word++;
+				}
+				else
+				{
+					denominators[terms++] = word[1] | static_cast<uint64_t>(word[2])<<32;
+					word += 3;
+				}
+			}
+			return terms != 0;
+		}
+
+	private:
+		static const uint64_t table_magic = 0x33424154544745ull;		//"EGTTAB3"
+		//a denominator which does not fit in 32 bits is written as this word, then its low and high halves
+		static const uint32_t wide_escape = numeric_limits<uint32_t>::max();
+
+		struct table_header
+		{
+			uint64_t magic = table_magic;
+			uint64_t bound = 0;
+			uint64_t divisors_count = 0;
+			uint64_t offsets_count = 0;
+			uint64_t pool_words = 0;
+		};
+
+		//rows[bound+1] only marks where the offsets and the pool of the last row end
+		struct table_row
+		{
+			uint64_t pool_base = 0;				//first pool word of the row
+			uint64_t first_offset = 0;			//first in-row offset of the row, there are totient(row)+1 of them
+			uint32_t first_divisor = 0;			//first square free divisor of the row except 1, negative for an odd number of primes
+			uint32_t reserved = 0;
+		};
+
+		static size_t encoded_words(const uint64_t* denominators, size_t terms)
+		{
+			size_t words = 0;
+			for(size_t idx = 0; idx < terms; ++idx)
+			{
+				words += denominators[idx] < wide_escape ? 1 : 3;
+			}
+			return words;
+		}
+
+		static void encode(const uint64_t* denominators, size_t terms, uint32_t* word)
+		{
+			for(size_t idx = 0; idx < terms; ++idx)
+			{
+				if(denominators[idx] < wide_escape)
+				{
+					*word++ = static_cast<uint32_t>(denominators[idx]);
+				}
+				else
+				{
+					*word++ = wide_escape;
+					*word++ = static_cast<uint32_t>(denominators[idx]);
+					*word++ = static_cast<uint32_t>(denominators[idx]>>32);
+				}
+			}
+		}
+
+		//numerators in [1, numerator) coprime with row, by inclusion-exclusion over the square free divisors of row. With numerator = row+1, this is Euler's totient of row
+		uint64_t coprime_rank(uint32_t numerator, uint32_t row) const
+		{
+			int64_t rank = numerator - 1;
+			for(uint32_t idx = rows[row].first_divisor, end = rows[row+1].first_divisor; idx < end; ++idx)
+			{
+				int32_t divisor = divisors[idx];
+				rank += divisor > 0 ? static_cast<int64_t>((numerator - 1)/static_cast<uint32_t>(divisor)) : -static_cast<int64_t>((numerator - 1)/static_cast<uint32_t>(-divisor));
+			}
+			return static_cast<uint64_t>(rank);
+		}
+
+		//positions relative to the end of the header
+		size_t divisors_position() const
+		{
+			return (header.bound + 2)*sizeof(table_row);
+		}
+
+		size_t offsets_position() const
+		{
+			return divisors_position() + header.divisors_count*sizeof(int32_t);
+		}
+
+		size_t pool_position() const
+		{
+			return offsets_position() + header.offsets_count*sizeof(uint32_t);
+		}
+
+		void unmap()
+		{
+			if(mapped != nullptr)
+			{
+				munmap(mapped, mapped_size);
+				mapped = nullptr;
+				rows = nullptr;
+				divisors = nullptr;
+				offsets = nullptr;
+				pool = nullptr;
+			}
+		}
+
+		table_header header;
+		//either point inside owned_rows/owned_divisors/owned_offsets/owned_pool (built table) or inside the mapped file
+		const table_row* rows = nullptr;
+		const int32_t* divisors = nullptr;
+		const uint32_t* offsets = nullptr;
+		const uint32_t* pool = nullptr;
+		vector<table_row> owned_rows;
+		vector<int32_t> owned_divisors;
+		vector<uint32_t> owned_offsets;
+		vector<uint32_t> owned_pool;
+		void* mapped = nullptr;
+		size_t mapped_size = 0;
+	};
+
+	//table lookup, with fallback to expand_fraction on a miss. On a hit, the denominators are decoded in the caller's buffer
+	expansion expand_with_table(const fraction_table& table, uint64_t numerator, uint64_t denominator, uint64_t* denominators, size_t capacity)
+	{
+		expansion result{0, 0, expansion_ok};
+		if(table.lookup(numerator, denominator, result.integer_part, denominators, capacity, result.terms))
+		{
+			return result;
+		}
+		return expand_fraction(numerator, denominator, denominators, capacity);
+	}
 }
 
 void egyptian_fraction()
@@ -111,4 +904,87 @@ void egyptian_fraction()
 	//for(auto res : result)
 	//	std::cout<<res<<std::endl;
 	
+	//iterative engine, which only writes denominators in the given buffer
+	const size_t max_terms = 32;
+	std::vector<std::pair<uint64_t, uint64_t>> batch;
+	for(const auto& fraction : fractions)
+	{
+		batch.push_back(std::make_pair(fraction.first, fraction.second));
+	}
+	std::vector<uint64_t> pool;
+	std::vector<egyptian_fraction_processing::expansion> expansions;
+	egyptian_fraction_processing::expand_batch(batch, max_terms, pool, expansions);
+	for(size_t idx = 0, size = batch.size(); idx < size; ++idx)
+	{
+		egyptian_fraction_processing::print_expansion(batch[idx].first, batch[idx].second, expansions[idx], pool.data() + idx*max_terms);
+	}
+	
+	//bounded search for the optimal expansions
+	egyptian_fraction_processing::optimization_budget budget{6, 1000000, std::chrono::milliseconds(2000)};
+	batch.push_back(std::make_pair(4, 17));
+	batch.push_back(std::make_pair(5, 121));
+	std::cout<<std::endl<<"fewest terms"<<std::endl;
+	for(const auto& fraction : batch)
+	{
+		egyptian_fraction_processing::print_optimized(fraction.first, fraction.second, egyptian_fraction_processing::optimize_fraction(fraction.first, fraction.second, egyptian_fraction_processing::fewest_terms, budget));
+	}
+	std::cout<<std::endl<<"smallest max denominator"<<std::endl;
+	for(const auto& fraction : batch)
+	{
+		egyptian_fraction_processing::print_optimized(fraction.first, fraction.second, egyptian_fraction_processing::optimize_fraction(fraction.first, fraction.second, egyptian_fraction_processing::smallest_max_denominator, budget));
+	}
+}
+
+void egyptian_fraction_benchmark()
+{
+	//the pool takes max_terms*8 bytes per fraction, so 256MB for this batch
+	const size_t max_terms = 32;
+	egyptian_fraction_processing::benchmark(1000000, 1000, max_terms);
+
+	//precomputed table, saved in the temporary directory and mapped back in memory. A bound of 10^4 gives ~3*10^7 reduced fractions and a ~560MB table, so a smaller one is used
+	const std::vector<std::pair<uint64_t, uint64_t>> batch{{4, 17}, {5, 121}, {3, 7}, {1999, 2000}, {2, 2001}};
+	std::cout<<std::endl<<"precomputed table"<<std::endl;
+	const std::string table_path = (std::filesystem::temp_directory_path()/"egyptian_fractions_table.bin").string();
+	{
+		egyptian_fraction_processing::fraction_table table;
+		double elapsed = benchmark_helpers::seconds([&]{table.build(2000, max_terms);});
+		std::cout<<"table for denominators up to "<<table.bound()<<": "<<table.memory_bytes()<<" bytes, built in "<<elapsed<<" s"<<std::endl;
+		table.save(table_path.c_str());
+	}
+	egyptian_fraction_processing::fraction_table table;
+	if(table.map(table_path.c_str()))
+	{
+		std::vector<uint64_t> buffer(max_terms);
+		for(const auto& fraction : batch)
+		{
+			egyptian_fraction_processing::print_expansion(fraction.first, fraction.second, egyptian_fraction_processing::expand_with_table(table, fraction.first, fraction.second, buffer.data(), buffer.size()), buffer.data());
+		}
+
+		//lookups against computing each expansion again
+		std::vector<std::pair<uint64_t, uint64_t>> queries(1000000);
+		benchmark_helpers::random_generator generator;
+		for(auto& query : queries)
+		{
+			query.second = 2 + generator.next(table.bound()-1);
+			query.first = 1 + generator.next(query.second-1);
+		}
+		size_t terms = 0;
+		double lookup_time = benchmark_helpers::seconds([&]
+			{
+				for(const auto& query : queries)
+				{
+					terms += egyptian_fraction_processing::expand_with_table(table, query.first, query.second, buffer.data(), buffer.size()).terms;
+				}
+			});
+		double compute_time = benchmark_helpers::seconds([&]
+			{
+				for(const auto& query : queries)
+				{
+					terms -= egyptian_fraction_processing::expand_fraction(query.first, query.second, buffer.data(), buffer.size()).terms;
+				}
+			});
+		std::cout<<queries.size()<<" conversions: "<<lookup_time<<" s with the table, "<<compute_time<<" s computing each one"<<(terms == 0 ? "" : " (results differ)")<<std::endl;
+	}
+	//the mapping stays valid after the file is removed
+	std::filesystem::remove(table_path);
 }
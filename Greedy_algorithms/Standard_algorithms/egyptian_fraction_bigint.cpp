@@ -0,0 +1,143 @@
+#include "standard_greedy_algorithms.hpp"
+#include "big_unsigned.hpp"
+#include <chrono>
+#include <cstdint>
+
+/*
+ * Problem description: same as Egyptian fraction (write a fraction as a sum of unique unit fractions), using the same Greedy approach (Fibonacci-Sylvester): take the greatest unit fraction
+ * 						1/ceiling not greater than the remainder, then proceed with the new remainder.
+ *
+ * Approach: The denominators grow doubly exponentially: the new denominator is denominator*ceiling, with ceiling about as large as the denominator itself. Inputs as small as 5/121 need
+ * 			 denominators with hundreds of digits after a few steps, so they overflow int (process_fraction) and even 64 bits (expand_fraction). Here, the values are big_unsigned, whose operations
+ * 			 use native arithmetic while the values fit in 64 bits and Karatsuba multiplication once they grow large enough.
+ * 			 So, the algorithm is the one of expand_fraction:
+ * 				Step 1: write the integer part separately and continue with the subunitary remainder
+ * 				Step 2: reduce the remainder a/b by gcd(a, b). If a is 1, b is the last denominator
+ * 				Step 3: otherwise, ceiling = b/a + 1 is the next denominator and the remainder becomes (a*ceiling - b)/(b*ceiling)
+ * 			 As the numerator strictly decreases at every step, there are at most a terms.
+ * 			 For every expansion, the time and the memory taken by the limbs of the denominators and of the remainder are reported.
+ */
+
+namespace egyptian_fraction_bigint
+{
+	using namespace std;
+
+	struct big_expansion
+	{
+		big_unsigned integer_part;
+		vector<big_unsigned> denominators;
+		size_t denominators_bytes = 0;		//memory taken by the limbs of all denominators
+		size_t peak_remainder_bytes = 0;	//largest memory taken by the limbs of the remainder's numerator and denominator
+		double seconds = 0;
+	};
+
+	void read_fractions_by_line(vector<pair<uint64_t, uint64_t>>& fractions)
+	{
+		ifstream file;
+		file.open("egyptian_fractions_hard.txt", ios::in);
+
+		string line;
+		uint64_t numerator, denominator;
+		while(getline(file, line))
+		{
+			//treat each line like a stream of characters, instead of string object
+			istringstream iss(line);
+			//parse the stream of characters and read it in appropriate data types
+			if(iss>>numerator>>denominator)
+			{
+				fractions.push_back(make_pair(numerator, denominator));
+			}
+		}
+
+		file.close();
+	}
+
+	//denominator must not be 0
+	void expand_fraction(const big_unsigned& numerator, const big_unsigned& denominator, big_expansion& result)
+	{
+		auto begin = chrono::steady_clock::now();
+		result = big_expansion();
+
+		//Step 1: integer part and subunitary remainder
+		big_unsigned remainder_numerator, remainder_denominator(denominator);
+		big_unsigned::divmod(numerator, denominator, result.integer_part, remainder_numerator);
+
+		const big_unsigned one(1);
+		while(!remainder_numerator.is_zero())
+		{
+			//Step 2: reduce the remainder
+			big_unsigned divisor = big_unsigned::gcd(remainder_numerator, remainder_denominator);
+			if(divisor != one)
+			{
+				remainder_numerator = remainder_numerator/divisor;
+				remainder_denominator = remainder_denominator/divisor;
+			}
+			result.peak_remainder_bytes = max(result.peak_remainder_bytes, 4*(remainder_numerator.limb_count() + remainder_denominator.limb_count()));
+
+			if(remainder_numerator == one)
+			{
+				result.denominators_bytes += 4*remainder_denominator.limb_count();
+				result.denominators.push_back(remainder_denominator);
+				break;
+			}
+
+			//Step 3: next unit fraction and new remainder
+			big_unsigned ceiling = remainder_denominator/remainder_numerator + one;
+			remainder_numerator = remainder_numerator*ceiling - remainder_denominator;
+			remainder_denominator = remainder_denominator*ceiling;
+
+			result.denominators_bytes += 4*ceiling.limb_count();
+			result.denominators.push_back(move(ceiling));
+		}
+
+		chrono::duration<double> elapsed = chrono::steady_clock::now() - begin;
+		result.seconds = elapsed.count();
+	}
+
+	void print_expansion(uint64_t numerator, uint64_t denominator, const big_expansion& result)
+	{
+		cout<<numerator<<"/"<<denominator<<" = ";
+		bool first_term = true;
+		if(!result.integer_part.is_zero() || result.denominators.empty())
+		{
+			cout<<result.integer_part.to_string();
+			first_term = false;
+		}
+		for(const big_unsigned& term : result.denominators)
+		{
+			cout<<(first_term ? "" : " + ")<<"1/"<<term.to_string();
+			first_term = false;
+		}
+		cout<<endl;
+
+		size_t largest_bits = result.denominators.empty() ? 0 : result.denominators.back().bit_length();
+		cout<<"    "<<result.denominators.size()<<" terms, largest denominator has "<<largest_bits<<" bits, "<<result.denominators_bytes<<" bytes of denominators, "
+			<<result.peak_remainder_bytes<<" bytes of remainder at peak, "<<result.seconds*1e6<<" us"<<endl;
+	}
+}
+
+void egyptian_fraction_big()
+{
+	std::vector<std::pair<uint64_t, uint64_t>> fractions;
+
+	egyptian_fraction_bigint::read_fractions_by_line(fractions);
+
+	egyptian_fraction_bigint::big_expansion result;
+	for(const auto& fraction : fractions)
+	{
+		if(fraction.second == 0)
+		{
+			std::cout<<fraction.first<<"/"<<fraction.second<<" = invalid fraction"<<std::endl;
+			continue;
+		}
+		egyptian_fraction_bigint::expand_fraction(big_unsigned(fraction.first), big_unsigned(fraction.second), result);
+		egyptian_fraction_bigint::print_expansion(fraction.first, fraction.second, result);
+	}
+
+	//a fraction whose greedy expansion goes far beyond the Karatsuba threshold
+	const uint64_t numerator = 39, denominator = 86137;
+	egyptian_fraction_bigint::expand_fraction(big_unsigned(numerator), big_unsigned(denominator), result);
+	size_t largest_bits = result.denominators.empty() ? 0 : result.denominators.back().bit_length();
+	std::cout<<numerator<<"/"<<denominator<<": "<<result.denominators.size()<<" terms, largest denominator has "<<largest_bits<<" bits, "<<result.denominators_bytes<<" bytes of denominators, "
+			 <<result.seconds*1e3<<" ms"<<std::endl;
+}
@@ -0,0 +1,204 @@
+#include "standard_greedy_algorithms.hpp"
+#include "../parallel_helpers.hpp"
+#include "../benchmark_helpers.hpp"
+#include <cstdint>
+
+/*
+ * Problem description: Given a set of N activities with their afferent starting times and end times, it is aimed to find the minimum number of resources (rooms, workers) needed to execute all of them,
+ * 						given a resource can execute one activity at a time. Also, each activity has to be assigned to a resource.
+ * 						Unlike activity selection, no activity is dropped here. As there, the next activity executed by a resource can start at the same time the previous one ends (start >= end).
+ *
+ * Approach: The number of needed resources is equal to the maximum number of activities overlapping at any given moment (the depth of the intervals set). The Greedy choice is to process the activities
+ * 			 in ascending order by their start time and to reuse, for each of them, the resource that gets free the earliest. If even that one is still busy, a new resource is needed.
+ * 			 There are 2 ways to implement it:
+ * 				- heap solution:
+ * 					Step 1: sort the activities by their start times, in ascending order
+ * 					Step 2: keep a min heap of pairs (end time, resource) for the resources currently in use
+ * 					Step 3: for each activity, if the top of the heap ends no later than the activity starts, pop it and reuse its resource. Otherwise, open a new resource. Push (activity end, resource) in heap.
+ * 				- sweep solution, which only uses flat arrays, so it scales to 10^8 activities:
+ * 					Step 1: sort the start times and, separately, the end times in ascending order. As the activities are needed for the assignment, each time is sorted together with its activity index.
+ * 					Step 2: sweep over the starts. Before processing a start, release all the activities whose end is <= the current start, by pushing their resources on a stack of free resources.
+ * 					Step 3: the current activity takes a free resource from the stack. If the stack is empty, a new resource is opened.
+ * 			 Both have O(NLogN) complexity, dominated by sorting. The sorting of the sweep solution can optionally be done in parallel.
+ */
+
+namespace interval_part
+{
+	using namespace std;
+
+	void read_activities_by_line(vector<unsigned>& starts, vector<unsigned>& ends)
+	{
+		ifstream file;
+		file.open("activities.txt", ios::in);
+
+		string line;
+		unsigned start, end;
+		while(getline(file, line))
+		{
+			//treat each line like a stream of characters, instead of string object
+			istringstream iss(line);
+			//parse the stream of characters and read it in appropriate data types
+			iss>>start>>end;
+			//push the read data into the used data structures. Starts and ends are kept in separate arrays, so they can be sorted independently by the sweep solution
+			starts.push_back(start);
+			ends.push_back(end);
+		}
+
+		file.close();
+	}
+
+	//returns the number of resources, while resource_of[idx] stores the resource assigned to the activity found at index idx in input arrays
+	unsigned partition_heap(const vector<unsigned>& starts, const vector<unsigned>& ends, vector<unsigned>& resource_of)
+	{
+		size_t size = starts.size();
+		resource_of.assign(size, 0);
+
+		//Step 1: sort activities indexes by their start time
+		vector<unsigned> order(size);
+		for(size_t idx = 0; idx < size; ++idx)
+		{
+			order[idx] = static_cast<unsigned>(idx);
+		}
+		sort(order.begin(), order.end(), [&starts](unsigned lhs, unsigned rhs){return starts[lhs] < starts[rhs];});
+
+		//Step 2: min heap of (end time, resource). greater<> puts the lowest end time on top
+		priority_queue<pair<unsigned, unsigned>, vector<pair<unsigned, unsigned>>, greater<pair<unsigned, unsigned>>> busy;
+		unsigned resources = 0;
+
+		//Step 3: for each activity, reuse the resource that gets free the earliest, if it is free by the activity's start time
+		for(unsigned activity : order)
+		{
+			unsigned resource;
+			if(!busy.empty() && busy.top().first <= starts[activity])
+			{
+				resource = busy.top().second;
+				busy.pop();
+			}
+			else
+			{
+				resource = resources++;
+			}
+
+			resource_of[activity] = resource;
+			busy.push(make_pair(ends[activity], resource));
+		}
+
+		return resources;
+	}
+
+	//same output as partition_heap, but built only on top of flat arrays. If use_parallel_sort is set, the 2 sorts are performed on multiple threads
+	unsigned partition_sweep(const vector<unsigned>& starts, const vector<unsigned>& ends, vector<unsigned>& resource_of, bool use_parallel_sort)
+	{
+		size_t size = starts.size();
+		resource_of.assign(size, 0);
+
+		//Step 1: sort activities once by start time and once by end time. Each activity is packed as (time<<32 | index) in a 64 bits key, so sorting compares plain integers
+		//and moves the keys sequentially, instead of indexing the times arrays at random on every comparison
+		vector<uint64_t> by_start(size), by_end(size);
+		for(size_t idx = 0; idx < size; ++idx)
+		{
+			by_start[idx] = (static_cast<uint64_t>(starts[idx])<<32) | idx;
+			by_end[idx] = (static_cast<uint64_t>(ends[idx])<<32) | idx;
+		}
+
+		if(use_parallel_sort)
+		{
+			parallel_helpers::parallel_sort(by_start.begin(), by_start.end(), less<uint64_t>());
+			parallel_helpers::parallel_sort(by_end.begin(), by_end.end(), less<uint64_t>());
+		}
+		else
+		{
+			sort(by_start.begin(), by_start.end());
+			sort(by_end.begin(), by_end.end());
+		}
+
+		//the resources released by finished activities. Its size never exceeds the number of resources
+		vector<unsigned> free_resources;
+		unsigned resources = 0;
+		size_t end_idx = 0;
+
+		//Step 2: sweep over starts in ascending order
+		for(uint64_t start_key : by_start)
+		{
+			unsigned activity = static_cast<unsigned>(start_key);
+
+			//release every activity finished by the current start, as its start is <= its end <= the current start, so it has been assigned already.
+			//Zero length activities are skipped here, as they give back their resource right when they are assigned (below)
+			while(end_idx < size && (by_end[end_idx]>>32) <= starts[activity])
+			{
+				unsigned finished = static_cast<unsigned>(by_end[end_idx]);
+				if(starts[finished] != ends[finished])
+				{
+					free_resources.push_back(resource_of[finished]);
+				}
+				++end_idx;
+			}
+
+			//Step 3: take a free resource, if any. Otherwise, open a new one
+			if(!free_resources.empty())
+			{
+				resource_of[activity] = free_resources.back();
+				free_resources.pop_back();
+			}
+			else
+			{
+				resource_of[activity] = resources++;
+			}
+
+			if(starts[activity] == ends[activity])
+			{
+				free_resources.push_back(resource_of[activity]);
+			}
+		}
+
+		return resources;
+	}
+
+	void print_assignment(const vector<unsigned>& starts, const vector<unsigned>& ends, const vector<unsigned>& resource_of, unsigned resources)
+	{
+		cout<<"needed resources: "<<resources<<endl;
+		cout<<" start time "<<" end time "<<" resource"<<endl;
+		for(size_t idx = 0, size = starts.size(); idx < size; ++idx)
+		{
+			cout<<"    "<<starts[idx]<<"          "<<ends[idx]<<"          "<<resource_of[idx]<<endl;
+		}
+	}
+
+	//generate random activities with durations up to max_duration and time the 3 variants against each other
+	void benchmark(size_t size, unsigned max_duration)
+	{
+		vector<unsigned> starts(size), ends(size), resource_of;
+		benchmark_helpers::random_generator generator;
+		for(size_t idx = 0; idx < size; ++idx)
+		{
+			starts[idx] = generator.next()>>4;
+			ends[idx] = starts[idx] + 1 + generator.next(max_duration);
+		}
+
+		cout<<"benchmark for "<<size<<" activities, resources needed"<<endl;
+		benchmark_helpers::time_it("heap", [&]{return partition_heap(starts, ends, resource_of);});
+		benchmark_helpers::time_it("sweep", [&]{return partition_sweep(starts, ends, resource_of, false);});
+		benchmark_helpers::time_it("sweep, parallel sort", [&]{return partition_sweep(starts, ends, resource_of, true);});
+	}
+}
+
+void interval_partitioning()
+{
+	std::vector<unsigned> starts, ends, resource_of;
+
+	interval_part::read_activities_by_line(starts, ends);
+
+	std::cout<<"heap solution"<<std::endl;
+	unsigned resources = interval_part::partition_heap(starts, ends, resource_of);
+	interval_part::print_assignment(starts, ends, resource_of, resources);
+
+	std::cout<<std::endl<<"sweep solution"<<std::endl;
+	resources = interval_part::partition_sweep(starts, ends, resource_of, true);
+	interval_part::print_assignment(starts, ends, resource_of, resources);
+}
+
+void interval_partitioning_benchmark()
+{
+	//the nightly runs go up to 10^8 activities (~2.8GB for the sweep solution, as it needs 2 keys of 8 bytes and 3 values of 4 bytes per activity). Keep this run shorter
+	interval_part::benchmark(10000000, 1000000);
+}
@@ -1,4 +1,5 @@
 #include "standard_greedy_algorithms.hpp"
+#include "../benchmark_helpers.hpp"
 
 /*
  * Problem description: Given a set of N jobs, each one being executed in a single unit of time (a day, let's say). Also, each job has associated 2 attributes:
@@ -25,6 +26,18 @@
  * 				Step 2: choose first job in the list by appending it to the results array, as it has the highest profit and mark the first position in time_slots array as true
  * 				Step 3: iterate over the remaining activities in list. At each iteration, also iterate over the time_slots array in descending order, strating with index = min(job.deadline, jobs_array.size). Substract 1 
  * for 0 based indexation compliance. Then, check if the value at any given index in time_slots array is false. If so, mark it as true and append the current job to results array.
+ *
+ * 			 The backward search for a free slot in step 3 is O(d) per job, so the whole algorithm becomes O(N*d) when many jobs share large deadlines. It can be replaced by a disjoint set (union-find)
+ * 			 structure that answers "which is the latest free slot not after day t" directly:
+ * 					 - each day t is a node whose parent is t itself while day t is free. Day 0 is a sentinel that means "no free slot left"
+ * 					 - when day t is taken, it is linked to day t-1. So the root of the set containing t is the latest free day <= t
+ * 					 - path compression links every visited node straight to the found root, so the next searches passing through them skip the already taken days
+ * 			 Thus, each job is placed in near constant amortized time and the algorithm becomes O(NLogN), dominated by sorting.
+ *
+ * 			 The same idea extends to M machines, each executing one job per day:
+ * 					 - every day gets a capacity counter, initialized to M. A job placed on a day takes the machine with index M - capacity, then the capacity is decremented
+ * 					 - a day is linked to the previous one only when its capacity reaches 0, so the union-find root is the latest day with remaining capacity
+ * 					 - at most ceil(N/M) days can be busy, so deadlines are clamped to this value, instead of N
  */ 
 
 namespace job_seq
@@ -89,6 +102,93 @@ namespace job_seq
 		}
 	}
 	
+	//latest free day not after the given day, or 0 if there is none. Uses path halving: each visited node is linked to its grandparent, which compresses the path while walking it
+	unsigned find_free_slot(vector<unsigned>& latest_free, unsigned day)
+	{
+		while(latest_free[day] != day)
+		{
+			latest_free[day] = latest_free[latest_free[day]];
+			day = latest_free[day];
+		}
+
+		return day;
+	}
+
+	//same as process_jobs, but the free slot is found by the union-find structure instead of scanning time_slots. Also, the first job is not forced on day 1, but placed on its latest free day, as any other job
+	void process_jobs_union_find(vector<tuple<char, unsigned, unsigned>>& jobs, vector<tuple<char, unsigned, unsigned>>& result, vector<unsigned>& day_of_execution)
+	{
+		//Step 1: sort input vector in descending order by profit
+		auto compare_profit_greater {[](tuple<char, unsigned, unsigned>& t1, tuple<char, unsigned, unsigned> &t2) 
+							{ 
+								return get<2>(t1) > get<2>(t2);
+							} 
+						  };
+		sort(jobs.begin(), jobs.end(), compare_profit_greater);
+
+		//Step 2: initially, every day is free so it is its own root. Index 0 is the sentinel, days are 1 based
+		unsigned days = static_cast<unsigned>(jobs.size());
+		vector<unsigned> latest_free(days+1);
+		for(unsigned day = 0; day <= days; ++day)
+		{
+			latest_free[day] = day;
+		}
+
+		//Step 3: place each job on the latest free day not after its deadline, if any
+		for(vector<tuple<char, unsigned, unsigned>>::iterator it = jobs.begin(), end = jobs.end(); it!=end; ++it)
+		{
+			unsigned day = find_free_slot(latest_free, min(get<1>(*it), days));
+			if(day != 0)
+			{
+				result.push_back(*it);
+				day_of_execution.push_back(day);
+				//mark the day as taken, by linking it to the previous one
+				latest_free[day] = day-1;
+			}
+		}
+	}
+
+	//same as process_jobs_union_find, but for the given number of machines. machine_of_execution stores the 0 based machine index of each selected job
+	void process_jobs_machines(vector<tuple<char, unsigned, unsigned>>& jobs, unsigned machines, vector<tuple<char, unsigned, unsigned>>& result, vector<unsigned>& day_of_execution, vector<unsigned>& machine_of_execution)
+	{
+		if(machines == 0)
+		{
+			return;
+		}
+
+		//Step 1: sort input vector in descending order by profit
+		auto compare_profit_greater {[](tuple<char, unsigned, unsigned>& t1, tuple<char, unsigned, unsigned> &t2) 
+							{ 
+								return get<2>(t1) > get<2>(t2);
+							} 
+						  };
+		sort(jobs.begin(), jobs.end(), compare_profit_greater);
+
+		//Step 2: every day is free and has all the machines available. Index 0 is the sentinel, days are 1 based
+		unsigned days = static_cast<unsigned>((jobs.size() + machines - 1)/machines);
+		vector<unsigned> latest_free(days+1), capacity(days+1, machines);
+		for(unsigned day = 0; day <= days; ++day)
+		{
+			latest_free[day] = day;
+		}
+
+		//Step 3: place each job on the latest day with a free machine, not after its deadline, if any
+		for(vector<tuple<char, unsigned, unsigned>>::iterator it = jobs.begin(), end = jobs.end(); it!=end; ++it)
+		{
+			unsigned day = find_free_slot(latest_free, min(get<1>(*it), days));
+			if(day != 0)
+			{
+				result.push_back(*it);
+				day_of_execution.push_back(day);
+				machine_of_execution.push_back(machines - capacity[day]);
+				//once all the machines are taken, link the day to the previous one
+				if(--capacity[day] == 0)
+				{
+					latest_free[day] = day-1;
+				}
+			}
+		}
+	}
+
 	void print_jobs_vector(const vector<tuple<char, unsigned, unsigned>>& jobs, vector<unsigned>& day_of_execution)
 	{
 		cout<<" job id "<<" deadline "<<" profit "<<" day of execution"<<endl;
@@ -99,6 +199,60 @@ namespace job_seq
 		}
 	}
 
+
+	void print_benchmark_result(const char* name, const vector<tuple<char, unsigned, unsigned>>& result, double elapsed)
+	{
+		unsigned long long profit = 0;
+		for(const auto& job : result)
+		{
+			profit += get<2>(job);
+		}
+		cout<<"    "<<name<<": "<<result.size()<<" jobs, profit "<<profit<<" in "<<elapsed<<" s"<<endl;
+	}
+
+	//generate random jobs with deadlines in [1, max_deadline] and time the union-find strategy. With compare_scan, the time slots scan is timed on the same jobs, side by side
+	void benchmark(size_t size, unsigned max_deadline, bool compare_scan)
+	{
+		vector<tuple<char, unsigned, unsigned>> jobs(size), input, result;
+		vector<unsigned> day_of_execution;
+		benchmark_helpers::random_generator generator;
+		for(auto& job : jobs)
+		{
+			unsigned deadline = 1 + generator.next(max_deadline);
+			job = make_tuple(static_cast<char>('a' + generator.next(26)), deadline, generator.next()>>8);
+		}
+
+		cout<<"benchmark for "<<size<<" jobs with deadlines up to "<<max_deadline<<endl;
+		//both strategies sort their input, so each one gets its own copy
+		if(compare_scan)
+		{
+			input = jobs;
+			vector<bool> time_slots(size, false);
+			double elapsed = benchmark_helpers::seconds([&]{process_jobs(input, result, time_slots, day_of_execution);});
+			print_benchmark_result("time slots scan", result, elapsed);
+			result.clear();
+			day_of_execution.clear();
+		}
+
+		input = jobs;
+		double elapsed = benchmark_helpers::seconds([&]{process_jobs_union_find(input, result, day_of_execution);});
+		print_benchmark_result("union-find", result, elapsed);
+
+		if(compare_scan)
+		{
+			cout<<"    the time slots scan is the baseline and is suboptimal: it forces the most profitable job on day 1, which can take the slot of a job due that day. "
+				<<"union-find places every job on its latest free day, so its profit is the optimal one"<<endl;
+		}
+	}
+
+	void print_jobs_vector(const vector<tuple<char, unsigned, unsigned>>& jobs, vector<unsigned>& day_of_execution, vector<unsigned>& machine_of_execution)
+	{
+		cout<<" job id "<<" deadline "<<" profit "<<" day of execution "<<" machine"<<endl;
+		for(size_t idx = 0, size = min(jobs.size(), day_of_execution.size()); idx < size; ++idx)
+		{
+			cout<<"   "<<get<0>(jobs[idx])<<"        "<<get<1>(jobs[idx])<<"        "<<get<2>(jobs[idx])<<"       "<<day_of_execution[idx]<<"               "<<machine_of_execution[idx]<<endl;
+		}
+	}
 }
 
 
@@ -115,4 +269,28 @@ void job_sequencing()
 	job_seq::process_jobs(jobs, result, time_slots, day_of_execution);
 	
 	job_seq::print_jobs_vector(result, day_of_execution);
+	
+	std::cout<<std::endl<<"union-find slots"<<std::endl;
+	jobs.clear();
+	result.clear();
+	day_of_execution.clear();
+	job_seq::read_jobs_by_line(jobs);
+	job_seq::process_jobs_union_find(jobs, result, day_of_execution);
+	job_seq::print_jobs_vector(result, day_of_execution);
+	
+	std::cout<<std::endl<<"union-find slots on 2 machines"<<std::endl;
+	std::vector<unsigned> machine_of_execution;
+	jobs.clear();
+	result.clear();
+	day_of_execution.clear();
+	job_seq::read_jobs_by_line(jobs);
+	job_seq::process_jobs_machines(jobs, 2, result, day_of_execution, machine_of_execution);
+	job_seq::print_jobs_vector(result, day_of_execution, machine_of_execution);
+}
+
+void job_sequencing_benchmark()
+{
+	//the time slots scan is O(N*D), so it needs minutes for 10^7 jobs. It is compared with union-find at 10^6, then union-find runs alone at 10^7
+	job_seq::benchmark(1000000, 1000000, true);
+	job_seq::benchmark(10000000, 10000000, false);
 }
@@ -0,0 +1,288 @@
+#include "standard_greedy_algorithms.hpp"
+#include "../parallel_helpers.hpp"
+#include "../benchmark_helpers.hpp"
+#include <cstdint>
+#include <cctype>
+#include <limits>
+
+/*
+ * Problem description: same as job sequencing (each job takes one unit of time, has a deadline and a profit awarded if executed no later than its deadline, maximize the total profit), but for inputs
+ * 						of about 10^8 jobs. At this size, vector<tuple<char, unsigned, unsigned>> is not an option anymore: ids do not fit in a char, sorting moves whole tuples around and
+ * 						time_slots has one entry per job.
+ *
+ * Approach: The Greedy approach is the same: sort by profit in descending order and place every job on the latest free day not after its deadline. What changes is the data layout:
+ * 				- the jobs are stored as a structure of arrays (job_table): 32 bits ids, 32 bits deadlines and 64 bits profits => 16 bytes per job
+ * 				- the jobs are not moved when sorting. Instead, an array of 32 bits indexes (a permutation) is sorted by the profit it points to
+ * 				- time_slots becomes a bitmap: one bit per day, and only min(number of jobs, largest deadline) days are tracked, as there cannot be more busy days than jobs. For 10^8 days this is 12.5MB
+ * 				- to find the latest free day not after the deadline, the bitmap is hierarchical: every bit at level L+1 tells if the afferent 64 bits word at level L is non zero. Thus, the search
+ * 				  goes up till it finds a non zero word, then down following the highest set bit => at most 2*log64(days) words are read for every job, instead of scanning day by day.
+ * 			 So:
+ * 				Step 1: sort the permutation by profit in descending order (in parallel)
+ * 				Step 2: mark all the days in [1, min(number of jobs, largest deadline)] as free
+ * 				Step 3: for every job in sorted order, find the latest free day not after its deadline. If there is one, the job takes it and the day's bit is cleared.
+ */
+
+namespace compact_job_seq
+{
+	using namespace std;
+
+	//structure of arrays: the job found at index idx is (ids[idx], deadlines[idx], profits[idx])
+	struct job_table
+	{
+		vector<uint32_t> ids;
+		vector<uint32_t> deadlines;
+		vector<uint64_t> profits;
+
+		size_t size() const
+		{
+			return ids.size();
+		}
+
+		void push_back(uint32_t id, uint32_t deadline, uint64_t profit)
+		{
+			ids.push_back(id);
+			deadlines.push_back(deadline);
+			profits.push_back(profit);
+		}
+	};
+
+	//the schedule is also kept as arrays: jobs[idx] is an index in the job_table, executed on days[idx]
+	struct schedule
+	{
+		vector<uint32_t> jobs;
+		vector<uint32_t> days;
+		uint64_t total_profit = 0;
+	};
+
+	//bitmap with a summary level on top of each level, till the top level fits in a single word
+	class slot_bitmap
+	{
+	public:
+		static const size_t npos = static_cast<size_t>(-1);
+
+		//all bits are cleared initially
+		explicit slot_bitmap(size_t size)
+		{
+			do
+			{
+				size = (size + 63)/64;
+				levels.push_back(vector<uint64_t>(size, 0));
+			}
+			while(size > 1);
+		}
+
+		//set the positions [0, size) at once, level by level
+		void set_all(size_t size)
+		{
+			for(vector<uint64_t>& level : levels)
+			{
+				fill(level.begin(), level.begin() + size/64, ~uint64_t{0});
+				if(size%64 != 0)
+				{
+					level[size/64] = (uint64_t{1}<<(size%64)) - 1;
+				}
+				size = (size + 63)/64;
+			}
+		}
+
+		void clear(size_t pos)
+		{
+			for(vector<uint64_t>& level : levels)
+			{
+				level[pos>>6] &= ~(uint64_t{1}<<(pos&63));
+				//the upper levels need to be updated only if the word became zero
+				if(level[pos>>6] != 0)
+				{
+					break;
+				}
+				pos >>= 6;
+			}
+		}
+
+		//highest set position <= pos, or npos if there is none
+		size_t predecessor(size_t pos) const
+		{
+			size_t level = 0;
+			//going up: look for a set bit in the current word, at or below pos. If there is none, the search continues from the previous word, one level up
+			while(true)
+			{
+				uint64_t bits = levels[level][pos>>6] & mask_up_to(pos&63);
+				if(bits != 0)
+				{
+					pos = (pos & ~size_t{63}) | highest_bit(bits);
+					break;
+				}
+
+				if((pos>>6) == 0 || level+1 == levels.size())
+				{
+					return npos;
+				}
+				pos = (pos>>6) - 1;
+				++level;
+			}
+
+			//going down: the found bit tells which word is non zero at the level below. Take its highest set bit
+			while(level > 0)
+			{
+				--level;
+				pos = (pos<<6) | highest_bit(levels[level][pos]);
+			}
+
+			return pos;
+		}
+
+	private:
+		static uint64_t mask_up_to(size_t bit)
+		{
+			return bit == 63 ? ~uint64_t{0} : (uint64_t{2}<<bit) - 1;
+		}
+
+		static size_t highest_bit(uint64_t bits)
+		{
+			return 63 - __builtin_clzll(bits);
+		}
+
+		//levels[0] holds one bit per day
+		vector<vector<uint64_t>> levels;
+	};
+
+	//ids are numbers in the input file. For compatibility with jobs_sequencing.txt, a single letter id is stored as its character code
+	void read_jobs_by_line(job_table& jobs, const char* file_name)
+	{
+		ifstream file;
+		file.open(file_name, ios::in);
+
+		string line, id;
+		uint32_t deadline;
+		uint64_t profit;
+		while(getline(file, line))
+		{
+			//treat each line like a stream of characters, instead of string object
+			istringstream iss(line);
+			//parse the stream of characters and read it in appropriate data types
+			if(iss>>id>>deadline>>profit)
+			{
+				uint32_t numeric_id = isdigit(static_cast<unsigned char>(id[0])) ? static_cast<uint32_t>(stoul(id)) : static_cast<uint32_t>(static_cast<unsigned char>(id[0]));
+				jobs.push_back(numeric_id, deadline, profit);
+			}
+		}
+
+		file.close();
+	}
+
+	void process_jobs(const job_table& jobs, schedule& result)
+	{
+		size_t size = jobs.size();
+		result = schedule();
+		if(size == 0)
+		{
+			return;
+		}
+
+		//Step 1: sort the permutation of indexes by profit, descending. Comparing through the indexes reads profits[] at random on every comparison, so the sort is done on temporary
+		//(complemented profit, index) keys instead: ascending order of ~profit is descending order of profit and equal profits keep the input order, regardless of the number of threads.
+		//The keys are dropped once the permutation is extracted from them
+		vector<uint32_t> order(size);
+		{
+			vector<pair<uint64_t, uint32_t>> keys(size);
+			for(size_t idx = 0; idx < size; ++idx)
+			{
+				keys[idx] = make_pair(~jobs.profits[idx], static_cast<uint32_t>(idx));
+			}
+			parallel_helpers::parallel_sort(keys.begin(), keys.end(), less<pair<uint64_t, uint32_t>>());
+			for(size_t idx = 0; idx < size; ++idx)
+			{
+				order[idx] = keys[idx].second;
+			}
+		}
+
+		//Step 2: days are 1 based, while bitmap positions are 0 based, so day d is found at position d-1
+		uint32_t days = static_cast<uint32_t>(min<size_t>(size, *max_element(jobs.deadlines.begin(), jobs.deadlines.end())));
+		if(days == 0)
+		{
+			return;
+		}
+		slot_bitmap free_days(days);
+		free_days.set_all(days);
+
+		//Step 3: place the jobs in descending order by profit
+		uint32_t remaining_days = days;
+		for(uint32_t job : order)
+		{
+			//once every day is taken, the remaining jobs cannot be scheduled
+			if(remaining_days == 0)
+			{
+				break;
+			}
+
+			//deadline 0 can never be met
+			uint32_t deadline = min(jobs.deadlines[job], days);
+			if(deadline == 0)
+			{
+				continue;
+			}
+
+			size_t pos = free_days.predecessor(deadline-1);
+			if(pos == slot_bitmap::npos)
+			{
+				continue;
+			}
+
+			free_days.clear(pos);
+			--remaining_days;
+
+			result.jobs.push_back(job);
+			result.days.push_back(static_cast<uint32_t>(pos+1));
+			result.total_profit += jobs.profits[job];
+		}
+	}
+
+	void print_schedule(const job_table& jobs, const schedule& result)
+	{
+		cout<<" job id "<<" deadline "<<" profit "<<" day of execution"<<endl;
+		for(size_t idx = 0, size = result.jobs.size(); idx < size; ++idx)
+		{
+			uint32_t job = result.jobs[idx];
+			cout<<"   "<<jobs.ids[job]<<"        "<<jobs.deadlines[job]<<"        "<<jobs.profits[job]<<"       "<<result.days[idx]<<endl;
+		}
+		cout<<"total profit: "<<result.total_profit<<endl;
+	}
+
+	//generate random jobs with deadlines in [1, max_deadline] and time the scheduling
+	void benchmark(size_t size, uint32_t max_deadline)
+	{
+		job_table jobs;
+		jobs.ids.resize(size);
+		jobs.deadlines.resize(size);
+		jobs.profits.resize(size);
+		benchmark_helpers::random_generator generator;
+		for(size_t idx = 0; idx < size; ++idx)
+		{
+			jobs.ids[idx] = static_cast<uint32_t>(idx);
+			jobs.deadlines[idx] = 1 + generator.next(max_deadline);
+			jobs.profits[idx] = generator.next();
+		}
+
+		schedule result;
+		double elapsed = benchmark_helpers::seconds([&]{process_jobs(jobs, result);});
+		cout<<"benchmark for "<<size<<" jobs with deadlines up to "<<max_deadline<<": "<<result.jobs.size()<<" jobs scheduled, profit "<<result.total_profit<<" in "<<elapsed<<" s"<<endl;
+	}
+}
+
+void job_sequencing_compact()
+{
+	compact_job_seq::job_table jobs;
+	compact_job_seq::schedule result;
+
+	compact_job_seq::read_jobs_by_line(jobs, "jobs_sequencing.txt");
+
+	compact_job_seq::process_jobs(jobs, result);
+
+	compact_job_seq::print_schedule(jobs, result);
+}
+
+void job_sequencing_compact_benchmark()
+{
+	//10^8 jobs need ~1.6GB for the table, 4 bytes per job for the permutation, 16 bytes per job for the temporary sorting keys and up to 8 bytes per scheduled job. Keep this run shorter
+	compact_job_seq::benchmark(10000000, 10000000);
+}
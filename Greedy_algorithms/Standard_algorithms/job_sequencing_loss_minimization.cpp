@@ -1,4 +1,6 @@
 #include "standard_greedy_algorithms.hpp"
+#include "../benchmark_helpers.hpp"
+#include <cstdint>
 
 /*
  * Problem description: Given a set of N jobs, each one being executed in a single unit of time (a day, let's say). Also, each job has associated 2 attributes:
@@ -22,6 +24,25 @@
  * 						Thus, if a job's deadline is less than its index in the sorted vector (+1 as it is 0 based), then search in the remaining jobs for another one using similar condition. 
  * 						Once found, check if the second job's deadline is greater than or equal first's one index. If so, swap them.
  * 							
+ * 			 Step 3 is O(N^2) and it only swaps pairs of late jobs, so it cannot recover every job that could be executed in due time. As each job takes a single unit of time, the loss is minimized when the
+ * 			 jobs executed in due time have the maximum total loss. Such a set can be built in O(NLogN) with a min heap, keyed by loss:
+ * 				Step 1: sort the jobs by deadline, in ascending order
+ * 				Step 2: iterate over them and push each job in the heap. The heap holds the jobs planned to be executed in due time, so if its size exceeds the current job's deadline, there are not
+ * 						enough days for all of them. The job with the lowest loss is popped and becomes late. The jobs in the heap are always feasible, as they can be executed in ascending order by deadline.
+ * 				Step 3: the final order is the in due time jobs, ascending by deadline, followed by the late ones (in any order, as their loss is incurred anyway). The late jobs are kept in descending order
+ * 						by the loss/time ratio, as in the initial approach.
+ *
+ * 			 The compare function of step 1 multiplies 2 unsigned values, so the products overflow for large losses and deadlines and the order becomes wrong. Also, every comparison does 2 multiplications.
+ * 			 Instead, an exact integer key can be computed once per job: key = floor(loss * 2^64 / time). As both loss and time are below 2^32, 2 different fractions differ by at least
+ * 			 1/(time1*time2) > 2^-64, so their keys differ by at least 1 and the keys order is exactly the fractions order, while equal fractions get equal keys. The key needs 96 bits, so it is computed
+ * 			 with 128 bits arithmetic and stored as 64 high bits plus 32 low bits, next to the job's index. The keys are radix sorted, so no comparison is done at all, and the permutation is applied at the end.
+ *
+ * 			 If time is seen as the processing time of a job and loss as its weight, ordering by loss/time is Smith's rule, which minimizes the total weighted completion time (sum of weight*completion)
+ * 			 on a single machine. For M machines, the same order is combined with list scheduling:
+ * 				Step 1: sort the jobs by loss/time, descending (with the exact keys above)
+ * 				Step 2: keep a min heap of (load, machine), where load is the time when the machine gets free
+ * 				Step 3: each job goes to the machine on top of the heap. Its completion time is the machine's load plus its processing time, which becomes the machine's new load.
+ * 			 This is O(NLogN + NLogM) and a heuristic: for M > 1 the problem is NP-hard, but the result is known to be within a factor of (1+sqrt(2))/2 from the optimum.
  */ 
 
 namespace loss_minimization
@@ -82,6 +103,178 @@ namespace loss_minimization
 		}
 	}
 
+	//exact loss/time key of a job, split in 2 parts, plus the job's index in the input vector
+	struct ratio_key
+	{
+		uint64_t high;
+		uint32_t low;
+		uint32_t index;
+	};
+
+	//same order as the compare function of process_jobs (descending by loss/time), but without overflow. Equal ratios keep the input order
+	void sort_by_ratio_keys(vector<tuple<char, unsigned, unsigned>>& jobs)
+	{
+		//Step 1: compute the keys once. A deadline of 0 means an infinite ratio, so it gets the maximum key
+		vector<ratio_key> keys(jobs.size());
+		for(size_t idx = 0, size = jobs.size(); idx < size; ++idx)
+		{
+			unsigned __int128 key = get<2>(jobs[idx]) == 0 ? ~static_cast<unsigned __int128>(0) : (static_cast<unsigned __int128>(get<1>(jobs[idx]))<<64)/get<2>(jobs[idx]);
+			keys[idx].high = static_cast<uint64_t>(key>>32);
+			keys[idx].low = static_cast<uint32_t>(key);
+			keys[idx].index = static_cast<uint32_t>(idx);
+		}
+
+		//Step 2: sort the keys descending with an LSD radix sort, 16 bits per pass. The digits are complemented, so ascending digits mean descending keys. Each pass is stable, so equal keys keep
+		//the input order. A pass where all keys share the same digit does not change anything, so it is skipped
+		vector<ratio_key> buffer(keys.size());
+		vector<size_t> offsets(1<<16);
+		for(unsigned pass = 0; pass < 6; ++pass)
+		{
+			auto digit{[pass](const ratio_key& key) -> unsigned
+						{
+							uint64_t part = pass < 2 ? key.low : key.high;
+							return static_cast<unsigned>(~(part>>(16*(pass < 2 ? pass : pass-2))) & 0xFFFF);
+						}
+					};
+
+			fill(offsets.begin(), offsets.end(), 0);
+			for(const ratio_key& key : keys)
+			{
+				++offsets[digit(key)];
+			}
+			if(!keys.empty() && offsets[digit(keys.front())] == keys.size())
+			{
+				continue;
+			}
+
+			//counts become starting positions
+			size_t position = 0;
+			for(size_t& offset : offsets)
+			{
+				size_t count = offset;
+				offset = position;
+				position += count;
+			}
+			for(const ratio_key& key : keys)
+			{
+				buffer[offsets[digit(key)]++] = key;
+			}
+			keys.swap(buffer);
+		}
+
+		//Step 3: apply the permutation
+		vector<tuple<char, unsigned, unsigned>> sorted_jobs;
+		sorted_jobs.reserve(jobs.size());
+		for(const ratio_key& key : keys)
+		{
+			sorted_jobs.push_back(jobs[key.index]);
+		}
+		jobs.swap(sorted_jobs);
+	}
+
+	//O(NLogN) replacement of process_jobs, which reorders the jobs so that the total loss is minimal
+	void process_jobs_heap(vector<tuple<char, unsigned, unsigned>>& jobs)
+	{
+		//Step 1: sort by deadline. stable_sort keeps the input order for equal deadlines
+		stable_sort(jobs.begin(), jobs.end(), [](const tuple<char, unsigned, unsigned>& job1, const tuple<char, unsigned, unsigned>& job2)
+							{
+								return get<2>(job1) < get<2>(job2);
+							});
+
+		//Step 2: min heap of (loss, index in sorted jobs) for the jobs executed in due time
+		priority_queue<pair<unsigned, size_t>, vector<pair<unsigned, size_t>>, greater<pair<unsigned, size_t>>> in_time;
+		vector<bool> late(jobs.size(), false);
+		for(size_t idx = 0, size = jobs.size(); idx < size; ++idx)
+		{
+			in_time.push(make_pair(get<1>(jobs[idx]), idx));
+			if(in_time.size() > get<2>(jobs[idx]))
+			{
+				late[in_time.top().second] = true;
+				in_time.pop();
+			}
+		}
+
+		//Step 3: in due time jobs first (still sorted by deadline), then the late ones sorted by loss/time ratio
+		vector<tuple<char, unsigned, unsigned>> ordered, late_jobs;
+		ordered.reserve(jobs.size());
+		for(size_t idx = 0, size = jobs.size(); idx < size; ++idx)
+		{
+			(late[idx] ? late_jobs : ordered).push_back(jobs[idx]);
+		}
+		stable_sort(late_jobs.begin(), late_jobs.end(), [](const tuple<char, unsigned, unsigned>& job1, const tuple<char, unsigned, unsigned>& job2)
+							{
+								return static_cast<unsigned long long>(get<1>(job1))*get<2>(job2) > static_cast<unsigned long long>(get<1>(job2))*get<2>(job1);
+							});
+		ordered.insert(ordered.end(), late_jobs.begin(), late_jobs.end());
+		jobs.swap(ordered);
+	}
+
+	//sum of the losses of the jobs executed after their deadline, given the job at index idx is executed on day idx+1
+	unsigned long long total_loss(const vector<tuple<char, unsigned, unsigned>>& jobs)
+	{
+		unsigned long long loss = 0;
+		for(size_t idx = 0, size = jobs.size(); idx < size; ++idx)
+		{
+			if(get<2>(jobs[idx]) < idx+1)
+			{
+				loss += get<1>(jobs[idx]);
+			}
+		}
+		return loss;
+	}
+
+	//list scheduling in Smith's order. jobs end up sorted descending by loss/time, machine_sequences[m] holds the indexes (in the sorted jobs) of the jobs executed by machine m, in order.
+	//Returns the total weighted completion time
+	unsigned long long schedule_machines(vector<tuple<char, unsigned, unsigned>>& jobs, unsigned machines, vector<vector<uint32_t>>& machine_sequences)
+	{
+		machine_sequences.assign(machines, vector<uint32_t>());
+		if(machines == 0)
+		{
+			return 0;
+		}
+
+		//Step 1: Smith's order
+		sort_by_ratio_keys(jobs);
+
+		//Step 2: all the machines are free at time 0
+		priority_queue<pair<unsigned long long, unsigned>, vector<pair<unsigned long long, unsigned>>, greater<pair<unsigned long long, unsigned>>> loads;
+		for(unsigned machine = 0; machine < machines; ++machine)
+		{
+			loads.push(make_pair(0ull, machine));
+		}
+
+		//Step 3: the machine that gets free first takes the next job
+		unsigned long long weighted_completion = 0;
+		for(size_t idx = 0, size = jobs.size(); idx < size; ++idx)
+		{
+			pair<unsigned long long, unsigned> machine = loads.top();
+			loads.pop();
+
+			unsigned long long completion = machine.first + get<2>(jobs[idx]);
+			weighted_completion += completion*get<1>(jobs[idx]);
+			machine_sequences[machine.second].push_back(static_cast<uint32_t>(idx));
+
+			loads.push(make_pair(completion, machine.second));
+		}
+
+		return weighted_completion;
+	}
+
+	void print_machine_sequences(const vector<tuple<char, unsigned, unsigned>>& jobs, const vector<vector<uint32_t>>& machine_sequences)
+	{
+		for(size_t machine = 0, machines = machine_sequences.size(); machine < machines; ++machine)
+		{
+			cout<<"    machine "<<machine<<" (job id, completion time):";
+			unsigned long long completion = 0;
+			for(uint32_t job : machine_sequences[machine])
+			{
+				completion += get<2>(jobs[job]);
+				cout<<" ("<<get<0>(jobs[job])<<", "<<completion<<")";
+			}
+			cout<<endl;
+		}
+	}
+
 	void print_jobs_vector(const vector<tuple<char, unsigned, unsigned>>& jobs)
 	{
 		cout<<" job id "<<" penalty "<<" deadline "<<" day of job execution"<<endl;
@@ -90,6 +283,77 @@ namespace loss_minimization
 			cout<<"   "<<get<0>(*it)<<"        "<<get<1>(*it)<<"        "<<get<2>(*it)<<"        "<<it-jobs.begin()+1<<endl;
 		}
 	}
+
+	//generate random jobs and time the given ordering function
+	void benchmark(const char* name, void (*process)(vector<tuple<char, unsigned, unsigned>>&), size_t size)
+	{
+		vector<tuple<char, unsigned, unsigned>> jobs(size);
+		benchmark_helpers::random_generator generator;
+		for(auto& job : jobs)
+		{
+			unsigned loss = 1 + generator.next(1000);
+			job = make_tuple(static_cast<char>('a' + generator.next(26)), loss, 1 + generator.next(size));
+		}
+
+		double elapsed = benchmark_helpers::seconds([&]{process(jobs);});
+		cout<<"    "<<name<<" for "<<size<<" jobs: total loss "<<total_loss(jobs)<<" in "<<elapsed<<" s"<<endl;
+	}
+
+	//time the 2 ways of sorting by loss/time on large random values and count how many neighbours the compare function of process_jobs leaves out of order
+	void benchmark_ratio_sort(size_t size)
+	{
+		vector<tuple<char, unsigned, unsigned>> jobs(size);
+		benchmark_helpers::random_generator generator;
+		for(auto& job : jobs)
+		{
+			unsigned loss = generator.next();
+			job = make_tuple(static_cast<char>('a' + generator.next(26)), loss, 1 + (generator.next()>>1));
+		}
+
+		auto count_out_of_order{[](const vector<tuple<char, unsigned, unsigned>>& sorted)
+						{
+							size_t wrong = 0;
+							for(size_t idx = 1, size = sorted.size(); idx < size; ++idx)
+							{
+								if(static_cast<uint64_t>(get<1>(sorted[idx-1]))*get<2>(sorted[idx]) < static_cast<uint64_t>(get<1>(sorted[idx]))*get<2>(sorted[idx-1]))
+								{
+									++wrong;
+								}
+							}
+							return wrong;
+						}
+					};
+
+		vector<tuple<char, unsigned, unsigned>> input(jobs);
+		double elapsed = benchmark_helpers::seconds([&]
+			{
+				sort(input.begin(), input.end(), [](tuple<char, unsigned, unsigned>& job1, tuple<char, unsigned, unsigned> &job2)
+									{
+										return get<1>(job1)*get<2>(job2) > get<1>(job2)*get<2>(job1);
+									});
+			});
+		cout<<"    unsigned products compare for "<<size<<" jobs: "<<count_out_of_order(input)<<" neighbours out of order, in "<<elapsed<<" s"<<endl;
+
+		elapsed = benchmark_helpers::seconds([&]{sort_by_ratio_keys(jobs);});
+		cout<<"    exact ratio keys for "<<size<<" jobs: "<<count_out_of_order(jobs)<<" neighbours out of order, in "<<elapsed<<" s"<<endl;
+	}
+
+	//random weights and processing times in [1, 1000], so the objective fits in 64 bits even for 10^7 jobs on a single machine
+	void benchmark_machines(size_t size, unsigned machines)
+	{
+		vector<tuple<char, unsigned, unsigned>> jobs(size);
+		vector<vector<uint32_t>> machine_sequences;
+		benchmark_helpers::random_generator generator;
+		for(auto& job : jobs)
+		{
+			unsigned weight = 1 + generator.next(1000);
+			job = make_tuple(static_cast<char>('a' + generator.next(26)), weight, 1 + generator.next(1000));
+		}
+
+		unsigned long long weighted_completion = 0;
+		double elapsed = benchmark_helpers::seconds([&]{weighted_completion = schedule_machines(jobs, machines, machine_sequences);});
+		cout<<"    list scheduling of "<<size<<" jobs on "<<machines<<" machines: total weighted completion time "<<weighted_completion<<" in "<<elapsed<<" s"<<endl;
+	}
 }
 
 void job_sequencing_loss_minimization()
@@ -101,4 +365,31 @@ void job_sequencing_loss_minimization()
 	loss_minimization::process_jobs(jobs);
 	
 	loss_minimization::print_jobs_vector(jobs);
+	std::cout<<"total loss: "<<loss_minimization::total_loss(jobs)<<std::endl;
+
+	std::cout<<std::endl<<"min heap solution"<<std::endl;
+	jobs.clear();
+	loss_minimization::read_jobs_by_line(jobs);
+	loss_minimization::process_jobs_heap(jobs);
+	loss_minimization::print_jobs_vector(jobs);
+	std::cout<<"total loss: "<<loss_minimization::total_loss(jobs)<<std::endl;
+
+	//same input, with time seen as processing time and loss as weight
+	std::cout<<std::endl<<"min weighted completion time on 2 machines"<<std::endl;
+	std::vector<std::vector<uint32_t>> machine_sequences;
+	jobs.clear();
+	loss_minimization::read_jobs_by_line(jobs);
+	unsigned long long weighted_completion = loss_minimization::schedule_machines(jobs, 2, machine_sequences);
+	loss_minimization::print_machine_sequences(jobs, machine_sequences);
+	std::cout<<"total weighted completion time: "<<weighted_completion<<std::endl;
+}
+
+void job_sequencing_loss_minimization_benchmark()
+{
+	//the swaps pass is already slow at 10^5 jobs, so it is compared on a smaller input
+	loss_minimization::benchmark("swaps pass", loss_minimization::process_jobs, 20000);
+	loss_minimization::benchmark("min heap", loss_minimization::process_jobs_heap, 20000);
+	loss_minimization::benchmark("min heap", loss_minimization::process_jobs_heap, 1000000);
+	loss_minimization::benchmark_ratio_sort(1000000);
+	loss_minimization::benchmark_machines(10000000, 1000);
 }
@@ -0,0 +1,438 @@
+#include "standard_greedy_algorithms.hpp"
+#include "../benchmark_helpers.hpp"
+#include <cstdint>
+#include <cctype>
+#include <limits>
+#include <set>
+#include <unordered_map>
+
+/*
+ * Problem description: same as job sequencing (each job takes one unit of time, has a deadline and a profit awarded if executed no later than its deadline, maximize the total profit), but the jobs
+ * 						arrive and get cancelled continuously. After every update, the max profit schedule has to be available, without sorting all the jobs again.
+ *
+ * Approach: A set of jobs can be scheduled (is feasible) if, for every day t, at most t of its jobs have deadline <= t. Let slack(t) = t - (number of scheduled jobs with deadline <= t).
+ * 			 The feasible sets form a matroid, which is exactly why the Greedy approach (by profit, descending) works for job sequencing. It also means the optimal schedule can be repaired
+ * 			 with a single exchange after each update:
+ * 				- arrival of job j with deadline d: add j to the schedule, so slack(t) decreases by 1 for every t >= d. If some slack became negative, let t1 be the first such day (t1 >= d).
+ * 				  Removing any scheduled job with deadline <= t1 fixes all the negative slacks, so the one with the lowest profit among them is moved out of the schedule (it can be j itself).
+ * 				- cancellation of a scheduled job j with deadline d: remove it, so slack(t) increases by 1 for every t >= d. Let t0 be the last day with slack 0 (or 0 if there is none).
+ * 				  A rejected job can now be added only if its deadline is > t0, so the one with the highest profit among them is moved in the schedule.
+ * 				- cancellation of a rejected job: just forget it.
+ * 			 So, the following structures are kept over the days 1..horizon:
+ * 				- a segment tree with range add and min, holding slack(t). It finds t1 and t0 in O(LogN)
+ * 				- for each deadline, the scheduled jobs and the rejected jobs ordered by profit (the "heaps" of each deadline), so their min and max are known
+ * 				- a segment tree with the min profit scheduled job of each deadline, answering prefix min queries (for [1, t1]) and one with the max profit rejected job, for suffix queries (for (t0, horizon])
+ * 			 Each update costs O(LogN). The total profit is kept up to date, while the days of execution are computed on demand, by walking the scheduled jobs in ascending order by deadline.
+ * 			 Deadlines greater than the horizon are clamped to it, so the days after the horizon are never used.
+ */
+
+namespace online_job_seq
+{
+	using namespace std;
+
+	//(profit, id) of a job. Pairs compare by profit first, so equal profits are broken by id
+	typedef pair<int64_t, uint32_t> job_key;
+
+	//segment tree over positions [0, size) with range add and min queries
+	class slack_tree
+	{
+	public:
+		explicit slack_tree(size_t size) : size(size), min_value(4*size), lazy(4*size, 0)
+		{
+			build(1, 0, size-1);
+		}
+
+		void add(size_t first, size_t last, int64_t value)
+		{
+			add(1, 0, size-1, first, last, value);
+		}
+
+		//first position >= from whose value is < threshold, or size if there is none
+		size_t first_below(size_t from, int64_t threshold)
+		{
+			return first_below(1, 0, size-1, from, threshold);
+		}
+
+		//last position whose value is < threshold, or size if there is none
+		size_t last_below(int64_t threshold)
+		{
+			return last_below(1, 0, size-1, threshold);
+		}
+
+	private:
+		//position p holds day p+1, whose slack is p+1 while there is no job scheduled
+		void build(size_t node, size_t node_first, size_t node_last)
+		{
+			if(node_first == node_last)
+			{
+				min_value[node] = static_cast<int64_t>(node_first) + 1;
+				return;
+			}
+			size_t middle = (node_first + node_last)/2;
+			build(2*node, node_first, middle);
+			build(2*node+1, middle+1, node_last);
+			min_value[node] = min(min_value[2*node], min_value[2*node+1]);
+		}
+
+		//propagate the pending add of a node to its children
+		void push(size_t node)
+		{
+			if(lazy[node] != 0)
+			{
+				for(size_t child = 2*node; child <= 2*node+1; ++child)
+				{
+					min_value[child] += lazy[node];
+					lazy[child] += lazy[node];
+				}
+				lazy[node] = 0;
+			}
+		}
+
+		void add(size_t node, size_t node_first, size_t node_last, size_t first, size_t last, int64_t value)
+		{
+			if(last < node_first || node_last < first)
+			{
+				return;
+			}
+			if(first <= node_first && node_last <= last)
+			{
+				min_value[node] += value;
+				lazy[node] += value;
+				return;
+			}
+			push(node);
+			size_t middle = (node_first + node_last)/2;
+			add(2*node, node_first, middle, first, last, value);
+			add(2*node+1, middle+1, node_last, first, last, value);
+			min_value[node] = min(min_value[2*node], min_value[2*node+1]);
+		}
+
+		size_t first_below(size_t node, size_t node_first, size_t node_last, size_t from, int64_t threshold)
+		{
+			if(node_last < from || min_value[node] >= threshold)
+			{
+				return size;
+			}
+			if(node_first == node_last)
+			{
+				return node_first;
+			}
+			push(node);
+			size_t middle = (node_first + node_last)/2;
+			size_t found = first_below(2*node, node_first, middle, from, threshold);
+			return found != size ? found : first_below(2*node+1, middle+1, node_last, from, threshold);
+		}
+
+		size_t last_below(size_t node, size_t node_first, size_t node_last, int64_t threshold)
+		{
+			if(min_value[node] >= threshold)
+			{
+				return size;
+			}
+			if(node_first == node_last)
+			{
+				return node_first;
+			}
+			push(node);
+			size_t middle = (node_first + node_last)/2;
+			size_t found = last_below(2*node+1, middle+1, node_last, threshold);
+			return found != size ? found : last_below(2*node, node_first, middle, threshold);
+		}
+
+		size_t size;
+		vector<int64_t> min_value, lazy;
+	};
+
+	//segment tree over positions [0, size) keeping the best job key of each position. Better is less<job_key> for min trees and greater<job_key> for max trees
+	template<typename Better>
+	class best_job_tree
+	{
+	public:
+		best_job_tree(size_t size, job_key empty) : size(size), empty(empty), best(2*size, empty)
+		{
+		}
+
+		void set(size_t pos, job_key key)
+		{
+			pos += size;
+			best[pos] = key;
+			for(pos /= 2; pos > 0; pos /= 2)
+			{
+				best[pos] = pick(best[2*pos], best[2*pos+1]);
+			}
+		}
+
+		//best key in [first, last], or the empty key if every position in range is empty
+		job_key query(size_t first, size_t last) const
+		{
+			job_key result = empty;
+			for(first += size, last += size+1; first < last; first /= 2, last /= 2)
+			{
+				if(first&1)
+				{
+					result = pick(result, best[first++]);
+				}
+				if(last&1)
+				{
+					result = pick(result, best[--last]);
+				}
+			}
+			return result;
+		}
+
+	private:
+		job_key pick(const job_key& lhs, const job_key& rhs) const
+		{
+			return Better()(rhs, lhs) ? rhs : lhs;
+		}
+
+		size_t size;
+		job_key empty;
+		vector<job_key> best;
+	};
+
+	class online_scheduler
+	{
+	public:
+		explicit online_scheduler(uint32_t horizon) :
+			horizon(max<uint32_t>(horizon, 1)),
+			slack(this->horizon),
+			scheduled_at(this->horizon + 1), rejected_at(this->horizon + 1),
+			min_scheduled(this->horizon + 1, no_min),
+			max_rejected(this->horizon + 1, no_max)
+		{
+		}
+
+		//returns false if the id is already known or the deadline is 0, as such a job can never be executed
+		bool add_job(uint32_t id, uint32_t deadline, int64_t profit)
+		{
+			if(deadline == 0 || jobs.count(id))
+			{
+				return false;
+			}
+
+			deadline = min(deadline, horizon);
+			jobs[id] = make_pair(deadline, profit);
+
+			//the job is scheduled first. If it breaks feasibility, the cheapest job with deadline <= t1 goes out
+			schedule(id, deadline, profit);
+			size_t t1 = slack.first_below(deadline-1, 0);
+			if(t1 != horizon)
+			{
+				job_key cheapest = min_scheduled.query(1, t1+1);
+				uint32_t cheapest_deadline = jobs[cheapest.second].first;
+				unschedule(cheapest.second, cheapest_deadline, cheapest.first);
+				reject(cheapest.second, cheapest_deadline, cheapest.first);
+			}
+
+			return true;
+		}
+
+		//returns false if the id is not known
+		bool cancel_job(uint32_t id)
+		{
+			unordered_map<uint32_t, pair<uint32_t, int64_t>>::iterator it = jobs.find(id);
+			if(it == jobs.end())
+			{
+				return false;
+			}
+
+			uint32_t deadline = it->second.first;
+			int64_t profit = it->second.second;
+			jobs.erase(it);
+
+			if(rejected_at[deadline].erase(make_pair(profit, id)))
+			{
+				update_max_rejected(deadline);
+				return true;
+			}
+
+			//a day got free, so the most profitable rejected job that fits after the last tight day comes back
+			unschedule(id, deadline, profit);
+			size_t t0 = slack.last_below(1);
+			uint32_t first_deadline = (t0 == horizon) ? 1 : static_cast<uint32_t>(t0) + 2;
+			if(first_deadline <= horizon)
+			{
+				job_key best = max_rejected.query(first_deadline, horizon);
+				if(best != no_max)
+				{
+					uint32_t best_deadline = jobs[best.second].first;
+					rejected_at[best_deadline].erase(best);
+					update_max_rejected(best_deadline);
+					schedule(best.second, best_deadline, best.first);
+				}
+			}
+
+			return true;
+		}
+
+		int64_t total_profit() const
+		{
+			return profit_sum;
+		}
+
+		size_t scheduled_count() const
+		{
+			return scheduled_jobs;
+		}
+
+		//(id, day of execution) of the scheduled jobs. Walking them in ascending order by deadline, the n-th job is executed on day n, which is always <= its deadline
+		void current_schedule(vector<pair<uint32_t, uint32_t>>& result) const
+		{
+			result.clear();
+			result.reserve(scheduled_jobs);
+			uint32_t day = 0;
+			for(uint32_t deadline = 1; deadline <= horizon; ++deadline)
+			{
+				for(const job_key& key : scheduled_at[deadline])
+				{
+					result.push_back(make_pair(key.second, ++day));
+				}
+			}
+		}
+
+	private:
+		void schedule(uint32_t id, uint32_t deadline, int64_t profit)
+		{
+			scheduled_at[deadline].insert(make_pair(profit, id));
+			min_scheduled.set(deadline, *scheduled_at[deadline].begin());
+			slack.add(deadline-1, horizon-1, -1);
+			profit_sum += profit;
+			++scheduled_jobs;
+		}
+
+		void unschedule(uint32_t id, uint32_t deadline, int64_t profit)
+		{
+			scheduled_at[deadline].erase(make_pair(profit, id));
+			min_scheduled.set(deadline, scheduled_at[deadline].empty() ? no_min : *scheduled_at[deadline].begin());
+			slack.add(deadline-1, horizon-1, 1);
+			profit_sum -= profit;
+			--scheduled_jobs;
+		}
+
+		void reject(uint32_t id, uint32_t deadline, int64_t profit)
+		{
+			rejected_at[deadline].insert(make_pair(profit, id));
+			update_max_rejected(deadline);
+		}
+
+		void update_max_rejected(uint32_t deadline)
+		{
+			max_rejected.set(deadline, rejected_at[deadline].empty() ? no_max : *rejected_at[deadline].rbegin());
+		}
+
+		//keys used for the deadlines without jobs, so they never win a query
+		static constexpr job_key no_min{numeric_limits<int64_t>::max(), numeric_limits<uint32_t>::max()};
+		static constexpr job_key no_max{numeric_limits<int64_t>::min(), 0};
+
+		uint32_t horizon;
+		slack_tree slack;
+		//indexed by deadline, so index 0 is never used
+		vector<set<job_key>> scheduled_at, rejected_at;
+		best_job_tree<less<job_key>> min_scheduled;
+		best_job_tree<greater<job_key>> max_rejected;
+		//id -> (clamped deadline, profit) for every known job, scheduled or rejected
+		unordered_map<uint32_t, pair<uint32_t, int64_t>> jobs;
+		int64_t profit_sum = 0;
+		size_t scheduled_jobs = 0;
+	};
+
+	//ids are numbers in the input file. For compatibility with jobs_sequencing.txt, a single letter id is stored as its character code
+	void read_jobs_by_line(vector<tuple<uint32_t, uint32_t, int64_t>>& jobs)
+	{
+		ifstream file;
+		file.open("jobs_sequencing.txt", ios::in);
+
+		string line, id;
+		uint32_t deadline;
+		int64_t profit;
+		while(getline(file, line))
+		{
+			//treat each line like a stream of characters, instead of string object
+			istringstream iss(line);
+			//parse the stream of characters and read it in appropriate data types
+			if(iss>>id>>deadline>>profit)
+			{
+				uint32_t numeric_id = isdigit(static_cast<unsigned char>(id[0])) ? static_cast<uint32_t>(stoul(id)) : static_cast<uint32_t>(static_cast<unsigned char>(id[0]));
+				jobs.push_back(make_tuple(numeric_id, deadline, profit));
+			}
+		}
+
+		file.close();
+	}
+
+	void print_schedule(const online_scheduler& scheduler)
+	{
+		vector<pair<uint32_t, uint32_t>> result;
+		scheduler.current_schedule(result);
+		cout<<"    scheduled (job id, day):";
+		for(const auto& job : result)
+		{
+			cout<<" ("<<job.first<<", "<<job.second<<")";
+		}
+		cout<<"  total profit: "<<scheduler.total_profit()<<endl;
+	}
+
+	//random mix of arrivals and cancellations over a fixed horizon
+	void benchmark(size_t updates, uint32_t horizon)
+	{
+		online_scheduler scheduler(horizon);
+		vector<uint32_t> alive;
+		benchmark_helpers::random_generator generator;
+		uint32_t next_id = 0;
+
+		double elapsed = benchmark_helpers::seconds([&]
+			{
+				for(size_t update = 0; update < updates; ++update)
+				{
+					//1 in 3 updates is a cancellation of a random known job
+					if(generator.next(3) == 0 && !alive.empty())
+					{
+						size_t pos = generator.next(alive.size());
+						scheduler.cancel_job(alive[pos]);
+						alive[pos] = alive.back();
+						alive.pop_back();
+					}
+					else
+					{
+						scheduler.add_job(next_id, 1 + generator.next(horizon), generator.next(1000000));
+						alive.push_back(next_id++);
+					}
+				}
+			});
+		cout<<"benchmark for "<<updates<<" updates over "<<horizon<<" days: "<<scheduler.scheduled_count()<<" jobs scheduled, profit "<<scheduler.total_profit()
+			<<" in "<<elapsed<<" s ("<<elapsed*1e9/updates<<" ns per update)"<<endl;
+	}
+}
+
+void job_sequencing_online()
+{
+	std::vector<std::tuple<uint32_t, uint32_t, int64_t>> jobs;
+
+	online_job_seq::read_jobs_by_line(jobs);
+
+	//the largest deadline in the file is the horizon
+	uint32_t horizon = 1;
+	for(const auto& job : jobs)
+	{
+		horizon = std::max(horizon, std::get<1>(job));
+	}
+
+	online_job_seq::online_scheduler scheduler(horizon);
+	for(const auto& job : jobs)
+	{
+		std::cout<<"arrival of job "<<std::get<0>(job)<<" (deadline "<<std::get<1>(job)<<", profit "<<std::get<2>(job)<<")"<<std::endl;
+		scheduler.add_job(std::get<0>(job), std::get<1>(job), std::get<2>(job));
+		online_job_seq::print_schedule(scheduler);
+	}
+
+	//cancel the most profitable job, so the rejected ones get a chance
+	std::cout<<"cancellation of job "<<std::get<0>(jobs.front())<<std::endl;
+	scheduler.cancel_job(std::get<0>(jobs.front()));
+	online_job_seq::print_schedule(scheduler);
+}
+
+void job_sequencing_online_benchmark()
+{
+	online_job_seq::benchmark(1000000, 100000);
+}
@@ -24,4 +24,34 @@ int main()
 	std::cout<<std::endl<<"--------Huffman encoding for sorted input. Same data as above is used, so same output is expected--------"<<std::endl;
 	//huffman_encoding_sorted_input();
 	brackets_swapping();
+	std::cout<<std::endl<<"--------Interval partitioning. Tip: sort by start time. Then reuse the resource that gets free the earliest (min heap of end times) or open a new one--------"<<std::endl;
+	//interval_partitioning();
+	std::cout<<std::endl<<"--------Weighted activity selection. Tip: Greedy does not hold for weights. Sort by end time, then DP where the previous compatible activity is found by binary search--------"<<std::endl;
+	//weighted_activity_selection();
+	std::cout<<std::endl<<"--------Job sequencing for 10^8 jobs. Tip: sort a permutation instead of the jobs. Keep free days in a hierarchical bitmap--------"<<std::endl;
+	//job_sequencing_compact();
+	std::cout<<std::endl<<"--------Online job sequencing. Tip: feasible job sets form a matroid, so after an arrival or a cancellation a single exchange restores the max profit schedule--------"<<std::endl;
+	//job_sequencing_online();
+	std::cout<<std::endl<<"--------Egyptian fraction with big integers. Tip: denominators grow doubly exponentially, so they need arbitrary precision. Reduce the remainder by gcd at each step--------"<<std::endl;
+	//egyptian_fraction_big();
+	std::cout<<std::endl<<"--------Brackets balance index. Tip: a segment tree of (net balance, minimum prefix balance) answers balance queries in O(logN) after each edit--------"<<std::endl;
+	//brackets_balance_index();
+	std::cout<<std::endl<<"--------Brackets swapping on large inputs. Tip: only the prefix balance is needed, so count without swapping, split the string between threads and stream it in fixed size buffers--------"<<std::endl;
+	//brackets_swapping_benchmark();
+	std::cout<<std::endl<<"--------Interval partitioning for 10^7 activities. Tip: a sweep over sorted start and end events needs no heap, and the sort can run in parallel--------"<<std::endl;
+	//interval_partitioning_benchmark();
+	std::cout<<std::endl<<"--------Weighted activity selection for 10^7 activities. Tip: the DP is O(NlogN), dominated by the sort and the binary searches--------"<<std::endl;
+	//weighted_activity_selection_benchmark();
+	std::cout<<std::endl<<"--------Job sequencing for 10^7 jobs. Tip: union-find links each taken day to the previous one, so the latest free day is found in near constant time instead of a scan--------"<<std::endl;
+	//job_sequencing_benchmark();
+	std::cout<<std::endl<<"--------Compact job sequencing for 10^7 jobs. Tip: a column table and a sorted permutation keep the memory per job small, the hierarchical bitmap finds free days with a few word scans--------"<<std::endl;
+	//job_sequencing_compact_benchmark();
+	std::cout<<std::endl<<"--------Online job sequencing for 10^6 updates. Tip: each arrival or cancellation costs a few logarithmic searches instead of rescheduling every job--------"<<std::endl;
+	//job_sequencing_online_benchmark();
+	std::cout<<std::endl<<"--------Job sequencing with loss minimization for 10^6 jobs. Tip: the swaps pass is quadratic, a min heap of in-time jobs is O(NlogN). Exact ratio keys avoid overflowing products, list scheduling spreads 10^7 jobs on 10^3 machines--------"<<std::endl;
+	//job_sequencing_loss_minimization_benchmark();
+	std::cout<<std::endl<<"--------Brackets balance index for 2^26 characters and 10^7 edits. Tip: each edit updates a leaf and its O(logN) ancestors, the queries only read the root or walk down once--------"<<std::endl;
+	//brackets_balance_index_benchmark();
+	std::cout<<std::endl<<"--------Egyptian fraction for 10^6 fractions. Tip: the iterative expansion shares no state, so a batch is split between threads. For small denominators, precompute all the expansions in a table mapped from a file--------"<<std::endl;
+	//egyptian_fraction_benchmark();
 }
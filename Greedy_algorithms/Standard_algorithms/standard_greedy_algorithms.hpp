@@ -24,3 +24,18 @@ void job_sequencing_loss_minimization();
 void huffman_encoding_and_decoding();
 void huffman_encoding_sorted_input();
 void brackets_swapping();
+void interval_partitioning();
+void weighted_activity_selection();
+void job_sequencing_compact();
+void job_sequencing_online();
+void egyptian_fraction_big();
+void brackets_balance_index();
+void brackets_swapping_benchmark();
+void interval_partitioning_benchmark();
+void weighted_activity_selection_benchmark();
+void job_sequencing_benchmark();
+void job_sequencing_compact_benchmark();
+void job_sequencing_online_benchmark();
+void job_sequencing_loss_minimization_benchmark();
+void brackets_balance_index_benchmark();
+void egyptian_fraction_benchmark();
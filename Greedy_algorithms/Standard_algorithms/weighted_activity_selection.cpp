@@ -0,0 +1,137 @@
+#include "standard_greedy_algorithms.hpp"
+#include "../benchmark_helpers.hpp"
+#include <cstdint>
+
+/*
+ * Problem description: Given a set of N activities with their afferent starting times, end times and weights (value gained if the activity is executed), it is aimed to choose the non overlapping
+ * 						activities that give the maximum total weight, given one activity can be executed at a time.
+ *
+ * Approach: The Greedy choice from activity selection (take the activity that finishes first) only holds when all weights are equal. Once they differ, one long activity can be worth more than
+ * 			 several short ones, so the choice made at each step depends on the choices made before => dynamic programming instead of Greedy.
+ * 			 Still, the first step of activity selection is kept: sorting by end time. After it, for every activity i its predecessor p(i) is defined as the number of activities that end no later
+ * 			 than activity i starts. As the array is sorted by end time, these are exactly the first p(i) activities and p(i) is found by binary search (upper_bound) over the end times.
+ * 			 So:
+ * 				Step 1: sort the activities by their end times, in ascending order
+ * 				Step 2: best[i] = max total weight using only the first i activities. best[0] = 0 and best[i] = max(best[i-1], weight(i) + best[p(i)]), where weight(i) is the weight of i-th activity
+ * 						(1 based) and p(i) is computed by binary search => O(NLogN)
+ * 				Step 3: reconstruct the solution walking back from i = N: if weight(i) + best[p(i)] > best[i-1], the i-th activity was chosen and the walk continues with p(i). Otherwise, continue with i-1.
+ * 						p(i) is computed again by binary search instead of being stored, so the only memory needed besides the sorted input is one int64 per activity.
+ */
+
+namespace weighted_activities
+{
+	using namespace std;
+
+	typedef struct activity
+	{
+		unsigned start, end, weight;
+	}s_activity;
+
+	void read_activities_by_line(vector<s_activity>& activities)
+	{
+		ifstream file;
+		file.open("weighted_activities.txt", ios::in);
+
+		string line;
+		s_activity act;
+		while(getline(file, line))
+		{
+			//treat each line like a stream of characters, instead of string object
+			istringstream iss(line);
+			//parse the stream of characters and read it in appropriate data types
+			iss>>act.start>>act.end>>act.weight;
+			activities.push_back(act);
+		}
+
+		file.close();
+	}
+
+	//number of activities, in the sorted array, that end no later than the given start time
+	size_t predecessor(const vector<s_activity>& activities, size_t last, unsigned start)
+	{
+		//only the first 'last' activities can be predecessors, as the others end later than the current one does
+		return upper_bound(activities.begin(), activities.begin() + last, start,
+						   [](unsigned value, const s_activity& act){return value < act.end;}) - activities.begin();
+	}
+
+	//returns the maximum total weight, while chosen stores the selected activities in ascending order by end time. The input is sorted in place
+	int64_t select_activities(vector<s_activity>& activities, vector<s_activity>& chosen)
+	{
+		chosen.clear();
+		size_t size = activities.size();
+
+		//Step 1: sort by end time
+		sort(activities.begin(), activities.end(), [](const s_activity& lhs, const s_activity& rhs){return lhs.end < rhs.end;});
+
+		//Step 2: best[i] is the max weight using the first i activities
+		vector<int64_t> best(size+1);
+		best[0] = 0;
+		for(size_t idx = 1; idx <= size; ++idx)
+		{
+			const s_activity& act = activities[idx-1];
+			int64_t with_current = act.weight + best[predecessor(activities, idx-1, act.start)];
+			best[idx] = max(best[idx-1], with_current);
+		}
+
+		//Step 3: walk back through best[] to find out which activities were chosen
+		for(size_t idx = size; idx > 0; )
+		{
+			const s_activity& act = activities[idx-1];
+			size_t pred = predecessor(activities, idx-1, act.start);
+			if(act.weight + best[pred] > best[idx-1])
+			{
+				chosen.push_back(act);
+				idx = pred;
+			}
+			else
+			{
+				--idx;
+			}
+		}
+		reverse(chosen.begin(), chosen.end());
+
+		return best[size];
+	}
+
+	void print_activities(const vector<s_activity>& chosen, int64_t total_weight)
+	{
+		cout<<" start time "<<" end time "<<" weight"<<endl;
+		for(const s_activity& act : chosen)
+		{
+			cout<<"    "<<act.start<<"          "<<act.end<<"          "<<act.weight<<endl;
+		}
+		cout<<"total weight: "<<total_weight<<endl;
+	}
+
+	//generate random weighted activities and time the DP
+	void benchmark(size_t size, unsigned max_duration)
+	{
+		vector<s_activity> activities(size), chosen;
+		benchmark_helpers::random_generator generator;
+		for(s_activity& act : activities)
+		{
+			act.start = generator.next()>>4;
+			act.end = act.start + 1 + generator.next(max_duration);
+			act.weight = 1 + generator.next(1000);
+		}
+
+		int64_t total_weight = 0;
+		double elapsed = benchmark_helpers::seconds([&]{total_weight = select_activities(activities, chosen);});
+		cout<<"benchmark for "<<size<<" activities: "<<chosen.size()<<" chosen, total weight "<<total_weight<<" in "<<elapsed<<" s"<<endl;
+	}
+}
+
+void weighted_activity_selection()
+{
+	std::vector<weighted_activities::s_activity> activities, chosen;
+
+	weighted_activities::read_activities_by_line(activities);
+
+	int64_t total_weight = weighted_activities::select_activities(activities, chosen);
+	weighted_activities::print_activities(chosen, total_weight);
+}
+
+void weighted_activity_selection_benchmark()
+{
+	weighted_activities::benchmark(10000000, 1000);
+}
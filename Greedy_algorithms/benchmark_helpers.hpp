@@ -0,0 +1,62 @@
+#ifndef BENCHMARK_HELPERS_HPP
+#define BENCHMARK_HELPERS_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+/*
+ * Helpers used by the benchmarks of both Standard_algorithms and Arrays_algorithms: a random generator for the inputs and a timer.
+ * The inputs only need to look shuffled and to be the same from one run to the next, so a linear congruential generator is used
+ * instead of the <random> engines and distributions, which would take longer than some of the algorithms being timed.
+ */
+
+namespace benchmark_helpers
+{
+	class random_generator
+	{
+	public:
+		explicit random_generator(uint64_t seed = 12345)
+			: state(seed)
+		{
+		}
+
+		//the low bits of a linear congruential generator repeat with short periods, so only the 32 high bits of the state are returned
+		uint32_t next()
+		{
+			state = state*6364136223846793005ull + 1442695040888963407ull;
+			return static_cast<uint32_t>(state>>32);
+		}
+
+		//value in [0, bound), for bound <= 2^32
+		uint32_t next(uint64_t bound)
+		{
+			return static_cast<uint32_t>(next()%bound);
+		}
+
+	private:
+		uint64_t state;
+	};
+
+	//seconds spent in func()
+	template<typename Func>
+	double seconds(Func func)
+	{
+		auto begin = std::chrono::steady_clock::now();
+		func();
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+		return elapsed.count();
+	}
+
+	//run func() and print its result and the time it took, on a line of its own
+	template<typename Func>
+	void time_it(const char* name, Func func)
+	{
+		auto begin = std::chrono::steady_clock::now();
+		auto result = func();
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+		std::cout<<"    "<<name<<": "<<result<<" in "<<elapsed.count()<<" s"<<std::endl;
+	}
+}
+
+#endif
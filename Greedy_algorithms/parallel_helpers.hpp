@@ -0,0 +1,156 @@
+#ifndef PARALLEL_HELPERS_HPP
+#define PARALLEL_HELPERS_HPP
+
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+
+/*
+ * Small helpers shared by the algorithms that can split their input in contiguous ranges and process each range on its own thread.
+ * There is no thread pool kept alive between calls: each call spawns its workers and joins them before returning, which is enough for
+ * the batch style used by the drivers. Both Standard_algorithms and Arrays_algorithms include this header, so there is a single copy of it.
+ */
+
+namespace parallel_helpers
+{
+	//number of threads to be spawned. hardware_concurrency() is allowed to return 0 when it cannot tell, so fall back to a single thread
+	inline unsigned workers_count()
+	{
+		unsigned workers = std::thread::hardware_concurrency();
+		return workers ? workers : 1;
+	}
+
+	//split [0, size) in at most 'workers' contiguous ranges and call func(first, last, worker_idx) for each of them on a separate thread
+	template<typename Func>
+	void parallel_for_ranges(size_t size, Func func, unsigned workers = workers_count())
+	{
+		if(size == 0)
+		{
+			return;
+		}
+
+		if(workers > size)
+		{
+			workers = static_cast<unsigned>(size);
+		}
+
+		//for one worker, do not pay the cost of spawning a thread
+		if(workers <= 1)
+		{
+			func(size_t{0}, size, 0u);
+			return;
+		}
+
+		std::vector<std::thread> threads;
+		threads.reserve(workers);
+		size_t chunk = size/workers, remainder = size%workers, first = 0;
+		for(unsigned worker = 0; worker < workers; ++worker)
+		{
+			//the first 'remainder' ranges get one more element, so the ranges sizes differ by at most 1
+			size_t last = first + chunk + (worker < remainder ? 1 : 0);
+			threads.emplace_back(func, first, last, worker);
+			first = last;
+		}
+
+		for(std::thread& th : threads)
+		{
+			th.join();
+		}
+	}
+
+	//blocks the threads calling wait() till all 'count' of them arrived, then releases them together. It can be reused, so threads spawned once
+	//can go through several phases of an algorithm, instead of being spawned again for each phase
+	class barrier
+	{
+	public:
+		explicit barrier(unsigned count)
+			: count(count)
+		{
+		}
+
+		//the last thread to arrive calls completion() before the others are released, so it can prepare the next phase alone
+		template<typename Func>
+		void wait(Func completion)
+		{
+			std::unique_lock<std::mutex> lock(mtx);
+			unsigned arrival_phase = phase;
+			if(++arrived == count)
+			{
+				completion();
+				arrived = 0;
+				++phase;
+				released.notify_all();
+			}
+			else
+			{
+				released.wait(lock, [&]{return phase != arrival_phase;});
+			}
+		}
+
+	private:
+		std::mutex mtx;
+		std::condition_variable released;
+		unsigned count;
+		unsigned arrived = 0;
+		unsigned phase = 0;
+	};
+
+	//sort each range in parallel, then merge neighbouring ranges pairwise (also in parallel) till a single sorted range is left
+	template<typename RandomIt, typename Compare>
+	void parallel_sort(RandomIt first, RandomIt last, Compare cmp, unsigned workers = workers_count())
+	{
+		size_t size = static_cast<size_t>(last - first);
+
+		//below this size, the threads spawning cost is not worth it
+		if(workers <= 1 || size < (size_t{1}<<16))
+		{
+			std::sort(first, last, cmp);
+			return;
+		}
+
+		//bounds[i] is the start of i-th sorted run, bounds.back() is the end of the input
+		std::vector<size_t> bounds(workers+1);
+		for(unsigned worker = 0; worker <= workers; ++worker)
+		{
+			bounds[worker] = size*worker/workers;
+		}
+
+		parallel_for_ranges(workers, [&](size_t run_first, size_t run_last, unsigned)
+			{
+				for(size_t run = run_first; run < run_last; ++run)
+				{
+					std::sort(first + bounds[run], first + bounds[run+1], cmp);
+				}
+			}, workers);
+
+		//each pass halves the number of runs
+		while(bounds.size() > 2)
+		{
+			size_t runs = bounds.size() - 1;
+			parallel_for_ranges(runs/2, [&](size_t pair_first, size_t pair_last, unsigned)
+				{
+					for(size_t pair = pair_first; pair < pair_last; ++pair)
+					{
+						std::inplace_merge(first + bounds[2*pair], first + bounds[2*pair+1], first + bounds[2*pair+2], cmp);
+					}
+				}, workers);
+
+			std::vector<size_t> merged_bounds;
+			for(size_t idx = 0; idx < bounds.size(); idx += 2)
+			{
+				merged_bounds.push_back(bounds[idx]);
+			}
+			//an odd number of runs leaves the last one unmerged in this pass, so its end must be kept
+			if(merged_bounds.back() != bounds.back())
+			{
+				merged_bounds.push_back(bounds.back());
+			}
+			bounds.swap(merged_bounds);
+		}
+	}
+}
+
+#endif